@@ -0,0 +1,231 @@
+/*
+ * Fledge "Python 3.5" notification delivery trace.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <logger.h>
+#include "delivery_trace.h"
+
+using namespace std;
+
+/**
+ * DeliveryTraceWriter constructor
+ *
+ * Open the trace file for appending, creating it with the
+ * file header if it does not exist.
+ *
+ * @param fileName	The trace file to append to
+ */
+DeliveryTraceWriter::DeliveryTraceWriter(const string& fileName) :
+					m_fileName(fileName),
+					m_lastSync(time(NULL))
+{
+	m_fd = open(m_fileName.c_str(), O_WRONLY | O_APPEND);
+	if (m_fd < 0 && errno == ENOENT && create())
+	{
+		m_fd = open(m_fileName.c_str(), O_WRONLY | O_APPEND);
+	}
+	if (m_fd < 0)
+	{
+		Logger::getLogger()->error("Unable to open delivery trace file '%s': %s",
+					   m_fileName.c_str(),
+					   strerror(errno));
+	}
+}
+
+/**
+ * DeliveryTraceWriter destructor, sync and close the trace file
+ */
+DeliveryTraceWriter::~DeliveryTraceWriter()
+{
+	if (m_fd >= 0)
+	{
+		fdatasync(m_fd);
+		close(m_fd);
+	}
+}
+
+/**
+ * Create the trace file with its header
+ *
+ * The header is written to a temporary file which is then linked
+ * to the trace file name, so that a writer opening the file at the
+ * same time never appends a record before the header.
+ *
+ * @return	True if the file exists, created by this or another writer
+ */
+bool DeliveryTraceWriter::create()
+{
+	string tmpName = m_fileName + ".XXXXXX";
+	int fd = mkstemp(&tmpName[0]);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	string header(DELIVERY_TRACE_MAGIC);
+	uint32_t version = DELIVERY_TRACE_VERSION;
+	header.append((const char *)&version, sizeof(version));
+	bool ret = write(fd, header.data(), header.length()) == (ssize_t)header.length();
+	fchmod(fd, 0644);
+	close(fd);
+
+	if (ret && link(tmpName.c_str(), m_fileName.c_str()) != 0 && errno != EEXIST)
+	{
+		ret = false;
+	}
+	int savedErrno = errno;
+	unlink(tmpName.c_str());
+	errno = savedErrno;
+
+	return ret;
+}
+
+/**
+ * Append a delivery to the trace file
+ *
+ * @param deliveryName		The delivery category name
+ * @param notificationName	The notification name
+ * @param triggerReason		The trigger reason for notification
+ * @param message		The message from notification
+ */
+void DeliveryTraceWriter::record(const string& deliveryName,
+				 const string& notificationName,
+				 const string& triggerReason,
+				 const string& message)
+{
+	if (m_fd < 0)
+	{
+		return;
+	}
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	uint64_t timestamp = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+
+	string buffer;
+	buffer.reserve(sizeof(timestamp) + 4 * sizeof(uint32_t) +
+		       deliveryName.length() + notificationName.length() +
+		       triggerReason.length() + message.length());
+	buffer.append((const char *)&timestamp, sizeof(timestamp));
+	appendString(buffer, deliveryName);
+	appendString(buffer, notificationName);
+	appendString(buffer, triggerReason);
+	appendString(buffer, message);
+
+	if (write(m_fd, buffer.data(), buffer.length()) != (ssize_t)buffer.length())
+	{
+		// Stop rather than append to a truncated record
+		Logger::getLogger()->error("Unable to write to delivery trace file '%s', capture stopped: %s",
+					   m_fileName.c_str(),
+					   strerror(errno));
+		close(m_fd);
+		m_fd = -1;
+		return;
+	}
+
+	if (tv.tv_sec - m_lastSync >= DELIVERY_TRACE_SYNC_INTERVAL)
+	{
+		fdatasync(m_fd);
+		m_lastSync = tv.tv_sec;
+	}
+}
+
+/**
+ * Append a length prefixed string to a record
+ *
+ * @param buffer	The record
+ * @param str		The string to append
+ */
+void DeliveryTraceWriter::appendString(string& buffer, const string& str)
+{
+	uint32_t len = str.length();
+	buffer.append((const char *)&len, sizeof(len));
+	buffer.append(str);
+}
+
+/**
+ * DeliveryTraceReader constructor
+ *
+ * Open the trace file and check its header
+ *
+ * @param fileName	The trace file to read
+ */
+DeliveryTraceReader::DeliveryTraceReader(const string& fileName)
+{
+	m_file = fopen(fileName.c_str(), "rb");
+	if (!m_file)
+	{
+		return;
+	}
+
+	char magic[sizeof(DELIVERY_TRACE_MAGIC)] = { 0 };
+	uint32_t version = 0;
+	if (fread(magic, 1, strlen(DELIVERY_TRACE_MAGIC), m_file) != strlen(DELIVERY_TRACE_MAGIC) ||
+	    fread(&version, sizeof(version), 1, m_file) != 1 ||
+	    strcmp(magic, DELIVERY_TRACE_MAGIC) != 0 ||
+	    version != DELIVERY_TRACE_VERSION)
+	{
+		fclose(m_file);
+		m_file = NULL;
+	}
+}
+
+/**
+ * DeliveryTraceReader destructor
+ */
+DeliveryTraceReader::~DeliveryTraceReader()
+{
+	if (m_file)
+	{
+		fclose(m_file);
+	}
+}
+
+/**
+ * Read the next delivery from the trace file
+ *
+ * @param record	The record to fill
+ * @return		False at the end of the file or on a truncated record
+ */
+bool DeliveryTraceReader::next(DeliveryTraceRecord& record)
+{
+	if (!m_file)
+	{
+		return false;
+	}
+
+	return fread(&record.m_timestamp, sizeof(record.m_timestamp), 1, m_file) == 1 &&
+	       readString(record.m_deliveryName) &&
+	       readString(record.m_notificationName) &&
+	       readString(record.m_triggerReason) &&
+	       readString(record.m_message);
+}
+
+/**
+ * Read a length prefixed string
+ *
+ * @param str	The string to fill
+ * @return	False if the string is truncated or its length is corrupt
+ */
+bool DeliveryTraceReader::readString(string& str)
+{
+	uint32_t len;
+	if (fread(&len, sizeof(len), 1, m_file) != 1 || len > DELIVERY_TRACE_MAX_STRING)
+	{
+		return false;
+	}
+
+	str.resize(len);
+	return len == 0 || fread(&str[0], 1, len, m_file) == len;
+}
@@ -0,0 +1,560 @@
+/*
+ * Fledge "Python 3.5" notification plugin HTTP helper for scripts.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include "http_helper.h"
+
+/**
+ * The fledge_http module exposed to delivery scripts:
+ *
+ *   post(url, body="", headers=None, timeout=10, callback=None)
+ *	Send an HTTP POST request and return a (status, body) tuple.
+ *	A Content-Type of application/json is sent unless set in headers.
+ *	If callback is given the request is queued for a worker thread,
+ *	post returns None and callback(status, body) is called on
+ *	completion, with status 0 and the error message on failure.
+ *	IOError is raised if the queue is full.
+ *
+ *   stats()
+ *	Return a dict of request statistics keyed by host:port.
+ */
+
+using namespace std;
+
+thread_local const void* HttpHelper::m_owner = NULL;
+
+/**
+ * Convert a Python dict of headers
+ *
+ * @param dict		The Python dict, may be NULL or None
+ * @param headers	The headers to fill
+ * @return		False with a Python exception set on errors
+ */
+static bool getHeaders(PyObject* dict, map<string, string>& headers)
+{
+	if (!dict || dict == Py_None)
+	{
+		return true;
+	}
+	if (!PyDict_Check(dict))
+	{
+		PyErr_SetString(PyExc_TypeError, "headers must be a dict");
+		return false;
+	}
+
+	PyObject *key, *value;
+	Py_ssize_t pos = 0;
+	while (PyDict_Next(dict, &pos, &key, &value))
+	{
+		const char *name = PyUnicode_AsUTF8(key);
+		const char *content = PyUnicode_AsUTF8(value);
+		if (!name || !content)
+		{
+			return false;
+		}
+		headers[name] = content;
+	}
+
+	return true;
+}
+
+/**
+ * fledge_http.post()
+ */
+static PyObject* http_post(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+	static const char *keywords[] = { "url", "body", "headers", "timeout", "callback", NULL };
+	const char *url;
+	const char *body = "";
+	Py_ssize_t bodyLen = 0;
+	PyObject *headersDict = NULL;
+	long timeout = HTTP_HELPER_DEFAULT_TIMEOUT;
+	PyObject *callback = NULL;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|s#OlO", (char **)keywords,
+					 &url, &body, &bodyLen,
+					 &headersDict, &timeout, &callback))
+	{
+		return NULL;
+	}
+
+	map<string, string> headers;
+	if (!getHeaders(headersDict, headers))
+	{
+		return NULL;
+	}
+
+	string requestURL(url);
+	string requestBody(body, bodyLen);
+	HttpHelper* helper = HttpHelper::getInstance();
+
+	if (callback && callback != Py_None)
+	{
+		if (!PyCallable_Check(callback))
+		{
+			PyErr_SetString(PyExc_TypeError, "callback must be callable");
+			return NULL;
+		}
+		if (!helper->postAsync(requestURL, requestBody, headers, timeout, callback))
+		{
+			PyErr_SetString(PyExc_IOError, "Too many HTTP requests queued");
+			return NULL;
+		}
+		Py_RETURN_NONE;
+	}
+
+	int status = 0;
+	string response, error;
+	bool ret;
+
+	// Other threads run Python while the request is in flight
+	Py_BEGIN_ALLOW_THREADS
+	ret = helper->post(requestURL, requestBody, headers, timeout, status, response, error);
+	Py_END_ALLOW_THREADS
+
+	if (!ret)
+	{
+		PyErr_SetString(PyExc_IOError, error.c_str());
+		return NULL;
+	}
+
+	PyObject* content = PyUnicode_DecodeUTF8(response.data(), response.size(), "replace");
+	if (!content)
+	{
+		return NULL;
+	}
+	PyObject* result = Py_BuildValue("(iN)", status, content);
+
+	return result;
+}
+
+/**
+ * fledge_http.stats()
+ */
+static PyObject* http_stats(PyObject* self, PyObject* args)
+{
+	return HttpHelper::getInstance()->getStatistics();
+}
+
+static PyMethodDef httpMethods[] = {
+	{ "post", (PyCFunction)(void(*)(void))http_post, METH_VARARGS | METH_KEYWORDS,
+	  "Send an HTTP POST request, returns (status, body)" },
+	{ "stats", http_stats, METH_NOARGS,
+	  "Return request statistics per endpoint" },
+	{ NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef httpModule = {
+	PyModuleDef_HEAD_INIT,
+	HTTP_HELPER_MODULE,
+	"Pooled HTTP requests for Fledge notification delivery scripts",
+	-1,
+	httpMethods
+};
+
+/**
+ * Return the helper shared by all plugin instances
+ */
+HttpHelper* HttpHelper::getInstance()
+{
+	static HttpHelper* instance = new HttpHelper();
+
+	return instance;
+}
+
+/**
+ * HttpHelper constructor
+ */
+HttpHelper::HttpHelper()
+{
+	m_logger = Logger::getLogger();
+}
+
+/**
+ * Add the fledge_http module to the interpreter, so that
+ * scripts can import it
+ *
+ * This method must be called while holding the GIL
+ *
+ * @return	True on success, false on errors.
+ */
+bool HttpHelper::registerModule()
+{
+	PyObject* modules = PyImport_GetModuleDict();
+	if (PyDict_GetItemString(modules, HTTP_HELPER_MODULE))
+	{
+		// Already added by another plugin instance
+		return true;
+	}
+
+	PyObject* module = PyModule_Create(&httpModule);
+	if (!module)
+	{
+		PyErr_Clear();
+		return false;
+	}
+#ifdef Py_GIL_DISABLED
+	// The helper does its own locking
+	PyUnstable_Module_SetGIL(module, Py_MOD_GIL_NOT_USED);
+#endif
+
+	bool ret = PyDict_SetItemString(modules, HTTP_HELPER_MODULE, module) == 0;
+	Py_DECREF(module);
+
+	return ret;
+}
+
+/**
+ * Split an http URL into the host:port endpoint and the path
+ *
+ * IPv6 address literals are not supported, the client
+ * takes everything after the first colon as the port.
+ *
+ * @param url		The URL
+ * @param endpoint	Set to host:port
+ * @param path		Set to the path and query
+ * @return		False if the URL is not an http URL
+ *			with a host and a valid port
+ */
+bool HttpHelper::parseURL(const string& url, string& endpoint, string& path)
+{
+	const string scheme("http://");
+	if (url.compare(0, scheme.length(), scheme) != 0)
+	{
+		return false;
+	}
+
+	size_t found = url.find('/', scheme.length());
+	if (found == string::npos)
+	{
+		endpoint = url.substr(scheme.length());
+		path = "/";
+	}
+	else
+	{
+		endpoint = url.substr(scheme.length(), found - scheme.length());
+		path = url.substr(found);
+	}
+
+	size_t colon = endpoint.find(':');
+	if (colon == 0 || endpoint.empty() || endpoint.find('[') != string::npos)
+	{
+		return false;
+	}
+	if (colon != string::npos)
+	{
+		string port = endpoint.substr(colon + 1);
+		if (port.empty() || port.length() > 5 ||
+		    port.find_first_not_of("0123456789") != string::npos ||
+		    atol(port.c_str()) < 1 || atol(port.c_str()) > 65535)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Send an HTTP POST request on a pooled connection
+ *
+ * This method must be called without holding the GIL
+ *
+ * @param url		The http URL
+ * @param body		The request body
+ * @param headers	The request headers
+ * @param timeout	The connect and request timeout in seconds
+ * @param status	Set to the response status code
+ * @param response	Set to the response body
+ * @param error		Set to the error message on failure
+ * @return		False if the request could not be sent or failed
+ */
+bool HttpHelper::post(const string& url,
+		      const string& body,
+		      const map<string, string>& headers,
+		      long timeout,
+		      int& status,
+		      string& response,
+		      string& error)
+{
+	string endpoint, path;
+	if (!parseURL(url, endpoint, path))
+	{
+		error = "Unsupported URL '" + url + "', only http://host[:port]/path URLs are supported";
+		return false;
+	}
+
+	// Take an idle connection for the endpoint or make a new one
+	shared_ptr<HttpClient> client;
+	bool pooled = false;
+	{
+		lock_guard<mutex> guard(m_mutex);
+		HttpEndpoint& stats = m_endpoints[endpoint];
+		if (!stats.m_idle.empty())
+		{
+			client = stats.m_idle.back();
+			stats.m_idle.pop_back();
+			pooled = true;
+		}
+	}
+	SimpleWeb::CaseInsensitiveMultimap header;
+	for (map<string, string>::const_iterator it = headers.begin(); it != headers.end(); ++it)
+	{
+		header.emplace(it->first, it->second);
+	}
+	if (header.find("Content-Type") == header.end())
+	{
+		header.emplace("Content-Type", "application/json");
+	}
+
+	bool ret = true;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	try
+	{
+		if (!client)
+		{
+			client = make_shared<HttpClient>(endpoint);
+		}
+		client->config.timeout = timeout;
+		client->config.timeout_connect = timeout;
+
+		auto res = client->request("POST", path, body, header);
+		status = atoi(res->status_code.c_str());
+		response = res->content.string();
+	}
+	catch (exception& e)
+	{
+		error = e.what();
+		ret = false;
+	}
+	double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	lock_guard<mutex> guard(m_mutex);
+	HttpEndpoint& stats = m_endpoints[endpoint];
+	stats.m_requests++;
+	stats.m_totalTime += elapsed;
+	if (elapsed > stats.m_maxTime)
+	{
+		stats.m_maxTime = elapsed;
+	}
+	if (pooled)
+	{
+		stats.m_pooled++;
+	}
+	if (!ret)
+	{
+		// Drop the connection, it may be broken
+		stats.m_failures++;
+	}
+	else if (stats.m_idle.size() < HTTP_HELPER_POOL_SIZE)
+	{
+		stats.m_idle.push_back(client);
+	}
+
+	return ret;
+}
+
+/**
+ * Queue an HTTP POST request for a worker thread, which calls
+ * callback(status, body) on completion
+ *
+ * This method must be called while holding the GIL
+ *
+ * @param url		The http URL
+ * @param body		The request body
+ * @param headers	The request headers
+ * @param timeout	The connect and request timeout in seconds
+ * @param callback	The Python callable to call on completion
+ * @return		False if the queue is full
+ */
+bool HttpHelper::postAsync(const string& url,
+			   const string& body,
+			   const map<string, string>& headers,
+			   long timeout,
+			   PyObject* callback)
+{
+	lock_guard<mutex> guard(m_mutex);
+	if (m_queue.size() >= HTTP_HELPER_QUEUE_SIZE)
+	{
+		return false;
+	}
+
+	// Start the workers on first use
+	if (m_workers.empty())
+	{
+		for (int i = 0; i < HTTP_HELPER_WORKERS; i++)
+		{
+			m_workers.push_back(thread(&HttpHelper::worker, this));
+		}
+	}
+
+	HttpRequest request;
+	request.m_url = url;
+	request.m_body = body;
+	request.m_headers = headers;
+	request.m_timeout = timeout;
+	request.m_callback = callback;
+	request.m_owner = m_owner;
+	Py_INCREF(callback);
+
+	m_queue.push_back(request);
+	m_pending[request.m_owner]++;
+	m_queueCond.notify_one();
+
+	return true;
+}
+
+/**
+ * Worker thread sending queued requests
+ *
+ * The helper lives as long as the process, so do its workers
+ */
+void HttpHelper::worker()
+{
+	while (true)
+	{
+		HttpRequest request;
+		{
+			unique_lock<mutex> guard(m_mutex);
+			m_queueCond.wait(guard, [this] { return !m_queue.empty(); });
+			request = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		int status = 0;
+		string response, error;
+		bool ret = post(request.m_url,
+				request.m_body,
+				request.m_headers,
+				request.m_timeout,
+				status,
+				response,
+				error);
+
+		PyGILState_STATE state = PyGILState_Ensure();
+
+		// Requests made by the callback belong to the same owner
+		m_owner = request.m_owner;
+
+		const string& content = ret ? response : error;
+		PyObject* pReturn = PyObject_CallFunction(request.m_callback, "is#",
+							  ret ? status : 0,
+							  content.data(),
+							  (Py_ssize_t)content.size());
+		if (!pReturn)
+		{
+			m_logger->error("Error in %s callback for request to '%s'",
+					HTTP_HELPER_MODULE,
+					request.m_url.c_str());
+			PyErr_Clear();
+		}
+		Py_XDECREF(pReturn);
+		Py_DECREF(request.m_callback);
+
+		m_owner = NULL;
+
+		PyGILState_Release(state);
+
+		lock_guard<mutex> guard(m_mutex);
+		if (--m_pending[request.m_owner] == 0)
+		{
+			m_pending.erase(request.m_owner);
+		}
+		m_pendingCond.notify_all();
+	}
+}
+
+/**
+ * Wait for the background requests of a plugin instance to complete
+ *
+ * This method must be called without holding the GIL
+ *
+ * @param owner		The plugin instance
+ * @param timeout	The maximum wait in seconds
+ * @return		False if requests are still pending
+ */
+bool HttpHelper::waitPending(const void* owner, long timeout)
+{
+	unique_lock<mutex> guard(m_mutex);
+	bool ret = m_pendingCond.wait_for(guard,
+					  chrono::seconds(timeout),
+					  [this, owner] { return m_pending.find(owner) == m_pending.end(); });
+	if (!ret)
+	{
+		m_logger->warn("%d %s requests still pending after %ld seconds",
+				m_pending[owner],
+				HTTP_HELPER_MODULE,
+				timeout);
+	}
+
+	return ret;
+}
+
+/**
+ * Return request statistics as a Python dict keyed by endpoint
+ *
+ * This method must be called while holding the GIL
+ */
+PyObject* HttpHelper::getStatistics()
+{
+	PyObject* result = PyDict_New();
+	if (!result)
+	{
+		return NULL;
+	}
+
+	lock_guard<mutex> guard(m_mutex);
+	for (map<string, HttpEndpoint>::const_iterator it = m_endpoints.begin();
+	     it != m_endpoints.end();
+	     ++it)
+	{
+		const HttpEndpoint& stats = it->second;
+		PyObject* item = Py_BuildValue("{s:l,s:l,s:l,s:d,s:d}",
+					       "requests", stats.m_requests,
+					       "failures", stats.m_failures,
+					       "pooled", stats.m_pooled,
+					       "average_ms", stats.m_requests ?
+							stats.m_totalTime / stats.m_requests : 0.0,
+					       "max_ms", stats.m_maxTime);
+		if (!item || PyDict_SetItemString(result, it->first.c_str(), item) != 0)
+		{
+			Py_XDECREF(item);
+			Py_DECREF(result);
+			return NULL;
+		}
+		Py_DECREF(item);
+	}
+
+	return result;
+}
+
+/**
+ * Log request statistics of each endpoint
+ */
+void HttpHelper::logStatistics()
+{
+	lock_guard<mutex> guard(m_mutex);
+	for (map<string, HttpEndpoint>::const_iterator it = m_endpoints.begin();
+	     it != m_endpoints.end();
+	     ++it)
+	{
+		const HttpEndpoint& stats = it->second;
+		m_logger->info("%s endpoint '%s': %ld requests, %ld failures, "
+				"%ld on pooled clients, average %.3f ms, maximum %.3f ms",
+				HTTP_HELPER_MODULE,
+				it->first.c_str(),
+				stats.m_requests,
+				stats.m_failures,
+				stats.m_pooled,
+				stats.m_requests ? stats.m_totalTime / stats.m_requests : 0.0,
+				stats.m_maxTime);
+	}
+}
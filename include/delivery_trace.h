@@ -0,0 +1,95 @@
+#ifndef _DELIVERY_TRACE_H
+#define _DELIVERY_TRACE_H
+/*
+ * Fledge "Python 3.5" notification delivery trace.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <string>
+
+// Trace file magic and format version
+#define DELIVERY_TRACE_MAGIC "FNDT"
+#define DELIVERY_TRACE_VERSION 1
+
+// Seconds between syncs of the trace file to disk
+#define DELIVERY_TRACE_SYNC_INTERVAL 5
+
+// Longest string accepted when reading a trace
+#define DELIVERY_TRACE_MAX_STRING (16 * 1024 * 1024)
+
+/**
+ * A single captured delivery
+ *
+ * The trace file is the magic and format version followed by
+ * one record per delivery: the timestamp in microseconds since
+ * the epoch and the four strings, each prefixed by its length.
+ * Integers are in host byte order.
+ */
+class DeliveryTraceRecord
+{
+	public:
+		uint64_t	m_timestamp;
+		std::string	m_deliveryName;
+		std::string	m_notificationName;
+		std::string	m_triggerReason;
+		std::string	m_message;
+};
+
+/**
+ * DeliveryTraceWriter appends deliveries to a trace file
+ *
+ * Each record is appended with a single write, so that several
+ * writers, e.g. deliveries capturing to the same file, do not
+ * interleave their records and a crash loses no capture.
+ * The file is synced to disk every DELIVERY_TRACE_SYNC_INTERVAL.
+ */
+class DeliveryTraceWriter
+{
+	public:
+		DeliveryTraceWriter(const std::string& fileName);
+		~DeliveryTraceWriter();
+
+		bool	isOpen() const { return m_fd >= 0; };
+		const std::string&
+			getFileName() const { return m_fileName; };
+		void	record(const std::string& deliveryName,
+			       const std::string& notificationName,
+			       const std::string& triggerReason,
+			       const std::string& message);
+
+	private:
+		bool	create();
+		static void
+			appendString(std::string& buffer, const std::string& str);
+
+	private:
+		std::string	m_fileName;
+		int		m_fd;
+		time_t		m_lastSync;
+};
+
+/**
+ * DeliveryTraceReader reads back deliveries from a trace file
+ */
+class DeliveryTraceReader
+{
+	public:
+		DeliveryTraceReader(const std::string& fileName);
+		~DeliveryTraceReader();
+
+		bool	isOpen() const { return m_file != NULL; };
+		bool	next(DeliveryTraceRecord& record);
+
+	private:
+		bool	readString(std::string& str);
+
+	private:
+		FILE*		m_file;
+};
+#endif
@@ -0,0 +1,145 @@
+#ifndef _HTTP_HELPER_H
+#define _HTTP_HELPER_H
+/*
+ * Fledge "Python 3.5" notification plugin HTTP helper for scripts.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <logger.h>
+#include <client_http.hpp>
+
+#include <Python.h>
+
+// Python module name of the helper
+#define HTTP_HELPER_MODULE "fledge_http"
+
+// Idle connections kept per endpoint
+#define HTTP_HELPER_POOL_SIZE 8
+
+// Default request timeout in seconds
+#define HTTP_HELPER_DEFAULT_TIMEOUT 10
+
+// Worker threads and queue size of requests with a callback
+#define HTTP_HELPER_WORKERS 4
+#define HTTP_HELPER_QUEUE_SIZE 256
+
+// Seconds a plugin instance shutdown waits for its queued requests
+#define HTTP_HELPER_SHUTDOWN_WAIT 30
+
+typedef SimpleWeb::Client<SimpleWeb::HTTP> HttpClient;
+
+/**
+ * Statistics and idle connections of an HTTP endpoint, host:port
+ */
+class HttpEndpoint
+{
+	public:
+		HttpEndpoint() : m_requests(0), m_failures(0), m_pooled(0),
+				 m_totalTime(0), m_maxTime(0) {};
+
+		std::vector<std::shared_ptr<HttpClient> >
+				m_idle;
+		long		m_requests;
+		long		m_failures;
+		// Requests sent on a pooled client, its kept alive
+		// connection is reused unless the server has closed it
+		long		m_pooled;
+		// Request latency in milliseconds
+		double		m_totalTime;
+		double		m_maxTime;
+};
+
+/**
+ * A request with a callback waiting for a worker thread
+ */
+class HttpRequest
+{
+	public:
+		std::string	m_url;
+		std::string	m_body;
+		std::map<std::string, std::string>
+				m_headers;
+		long		m_timeout;
+		PyObject*	m_callback;
+		// The plugin instance whose script queued the request
+		const void*	m_owner;
+};
+
+/**
+ * HttpHelper sends HTTP requests for delivery scripts
+ *
+ * It is exposed to scripts as the fledge_http module. Connections
+ * are kept alive and pooled per endpoint, and the GIL is released
+ * while a request is in flight.
+ * One helper is shared by all the plugin instances in the service,
+ * requests with a callback are counted against the plugin instance
+ * that set itself as owner of the calling thread.
+ */
+class HttpHelper
+{
+	public:
+		static HttpHelper*
+			getInstance();
+		static bool
+			registerModule();
+		static void
+			setOwner(const void* owner) { m_owner = owner; };
+
+		bool	post(const std::string& url,
+			     const std::string& body,
+			     const std::map<std::string, std::string>& headers,
+			     long timeout,
+			     int& status,
+			     std::string& response,
+			     std::string& error);
+		bool	postAsync(const std::string& url,
+				  const std::string& body,
+				  const std::map<std::string, std::string>& headers,
+				  long timeout,
+				  PyObject* callback);
+		bool	waitPending(const void* owner, long timeout);
+		PyObject*
+			getStatistics();
+		void	logStatistics();
+
+	private:
+		HttpHelper();
+		void	worker();
+		static bool
+			parseURL(const std::string& url,
+				 std::string& endpoint,
+				 std::string& path);
+
+	private:
+		std::mutex	m_mutex;
+		std::map<std::string, HttpEndpoint>
+				m_endpoints;
+		// Asynchronous requests queued or in flight per owner
+		std::map<const void*, int>
+				m_pending;
+		std::condition_variable
+				m_pendingCond;
+		std::deque<HttpRequest>
+				m_queue;
+		std::condition_variable
+				m_queueCond;
+		std::vector<std::thread>
+				m_workers;
+		Logger		*m_logger;
+		// The plugin instance running a script on this thread
+		static thread_local const void*
+				m_owner;
+};
+#endif
@@ -11,12 +11,23 @@
  */
 
 #include <mutex>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 
 #include <filter_plugin.h>
 #include <filter.h>
 
 #include <Python.h>
 
+#if defined(PYTHON_FREE_THREADED) && !defined(Py_GIL_DISABLED)
+#error "PYTHON_FREE_THREADED set without free-threaded Python headers"
+#endif
+
+#include "delivery_trace.h"
+#include "python_gc.h"
+
 #define PLUGIN_NAME "python35"
 
 // Relative path to FLEDGE_DATA
@@ -26,6 +37,31 @@
 // When max is reached a log messages will be added and counter is rest
 #define MAX_ERRORS_COUNT 100
 
+// Default wait in milliseconds for a background script import
+#define DEFAULT_IMPORT_WAIT_TIMEOUT 5000
+
+// Default garbage collection mode and idle interval in seconds
+#define DEFAULT_GC_MODE "automatic"
+#define DEFAULT_GC_IDLE_INTERVAL 10
+
+/**
+ * A script run after the main script in the delivery pipeline
+ */
+class ScriptStage
+{
+	public:
+		ScriptStage(const std::string& script, const std::string& method) :
+				m_script(script),
+				m_method(method),
+				m_pModule(NULL),
+				m_pFunc(NULL) {};
+
+		std::string	m_script;
+		std::string	m_method;
+		PyObject*	m_pModule;
+		PyObject*	m_pFunc;
+};
+
 /**
  * NotifyPython35 handles plugin configuration and Python objects
  */
@@ -59,10 +95,48 @@ class NotifyPython35
 		bool	isEnabled() const { return m_enabled; };
 		void	lock() { m_configMutex.lock(); };
 		void	unlock() { m_configMutex.unlock(); };
-		void	logErrorMessage();
+		void	logErrorMessage() { logErrorMessage(m_pythonScript); };
+		void	logErrorMessage(const std::string& scriptName);
 		void	shutdown();
 		bool	init();
-		
+		bool	waitForImport();
+		void	setTraceFile(const std::string& fileName);
+		// Append a delivery to the trace file, if capture is on
+		void	trace(const std::string& deliveryName,
+			      const std::string& notificationName,
+			      const std::string& triggerReason,
+			      const std::string& message)
+		{
+			if (m_trace)
+			{
+				m_trace->record(deliveryName,
+						notificationName,
+						triggerReason,
+						message);
+			}
+		};
+
+	private:
+		void	backgroundImport();
+		void	setReady();
+		bool	isReady();
+		void	setGarbageCollection();
+		void	setStages(const std::string& pipeline);
+		bool	importStages();
+		void	clearStages();
+		PyObject*
+			importScript(const std::string& script, bool reload);
+		PyObject*
+			importCompiled(const std::string& script);
+		PyObject*
+			runStages(PyObject* value,
+				  const std::vector<ScriptStage>& stages,
+				  std::string& scriptName);
+#ifdef PYTHON_FREE_THREADED
+		bool	notifyConcurrent(std::unique_lock<std::mutex>& guard,
+					 const std::string& message);
+#endif
+
 	private:
 		// Python 3.5 loaded filter module handle
 		PyObject*	m_pModule;
@@ -82,5 +156,40 @@ class NotifyPython35
 		Logger		*m_logger;
 		bool		m_failedScript;
 		int		m_execCount;
+		// Import the script on a background thread
+		bool		m_backgroundImport;
+		// Maximum wait for the background import, in milliseconds
+		long		m_importTimeout;
+		// Script import has completed, protected by m_readyMutex
+		bool		m_ready;
+		std::mutex	m_readyMutex;
+		std::condition_variable
+				m_readyCond;
+		std::thread	m_importThread;
+		std::chrono::steady_clock::time_point
+				m_initStart;
+		// Concurrent deliveries, free-threaded Python only
+		int		m_maxConcurrency;
+		int		m_inFlight;
+		// Incremented by each reconfiguration
+		unsigned long	m_configGeneration;
+		std::condition_variable
+				m_slotCond;
+		// Delivery capture, NULL when disabled
+		DeliveryTraceWriter*
+				m_trace;
+		// Garbage collection mode and idle interval
+		std::string	m_gcMode;
+		long		m_gcIdleInterval;
+		// Idle garbage collection, NULL when automatic
+		PythonGC*	m_gc;
+		// Pipeline stages run after the main script
+		std::vector<ScriptStage>
+				m_stages;
+		// Stage scripts set by configuration, imported by configure
+		std::vector<ScriptStage>
+				m_newStages;
+		// Compile scripts into extension modules
+		bool		m_compileScript;
 };
 #endif
@@ -0,0 +1,82 @@
+#ifndef _PYTHON_GC_H
+#define _PYTHON_GC_H
+/*
+ * Fledge "Python 3.5" notification plugin garbage collection scheduling.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+#include <logger.h>
+
+#include <Python.h>
+
+// A collection is forced after this many busy idle intervals
+#define GC_MAX_DEFERRED_INTERVALS 10
+
+/**
+ * PythonGC moves Python cyclic garbage collection out of deliveries
+ *
+ * While an instance is running the automatic collector is disabled,
+ * collections are run by a timer thread when no delivery has been
+ * made for an idle interval, or when they have been deferred too long.
+ * Once the script is imported the heap is unfrozen, so that objects
+ * dropped by a reload can be collected, a collection is run and the
+ * surviving objects are frozen so that later collections do not scan them.
+ *
+ * The collector is shared by the whole interpreter: automatic
+ * collection is enabled again when the last instance stops.
+ * The destructor must not be called while holding the GIL.
+ */
+class PythonGC
+{
+	public:
+		PythonGC(const std::string& name, long idleInterval);
+		~PythonGC();
+
+		long	getIdleInterval() const { return m_idleInterval; };
+		void	freeze();
+		// Record a delivery, deferring idle collection
+		void	activity()
+		{
+			m_lastActivity = std::chrono::steady_clock::now().time_since_epoch().count();
+		};
+
+	private:
+		void	run();
+		void	collect();
+		bool	callCollector(const char *method);
+
+	private:
+		std::string	m_name;
+		// Idle interval in seconds
+		long		m_idleInterval;
+		std::atomic<std::chrono::steady_clock::rep>
+				m_lastActivity;
+		std::chrono::steady_clock::time_point
+				m_lastCollection;
+		bool		m_stop;
+		std::mutex	m_mutex;
+		std::condition_variable
+				m_cond;
+		std::thread	m_thread;
+		Logger		*m_logger;
+		// Collection statistics, protected by m_mutex
+		long		m_collections;
+		long		m_collected;
+		double		m_totalPause;
+		double		m_maxPause;
+		// Running instances
+		static int	m_instances;
+		static std::mutex
+				m_instancesMutex;
+};
+#endif
@@ -0,0 +1,63 @@
+#ifndef _SCRIPT_COMPILER_H
+#define _SCRIPT_COMPILER_H
+/*
+ * Fledge "Python 3.5" notification plugin script compiler.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <string>
+#include <set>
+#include <mutex>
+
+#include <logger.h>
+
+// Directory of compiled scripts, relative to the scripts path
+#define COMPILED_SCRIPTS_DIR "/compiled"
+
+// Command compiling a script into an extension module in place
+#define SCRIPT_COMPILER_COMMAND "cythonize -3 -i -q"
+
+/**
+ * ScriptCompiler compiles delivery scripts into extension modules
+ *
+ * Compiled modules are cached in a directory named after the script
+ * and the hash of its content, so a script is compiled once for
+ * each change. Each compilation runs in a private directory that is
+ * then renamed into place, so a partly written module is never loaded.
+ * Modules compiled from earlier versions of the script are then removed.
+ * A version of a script that fails to compile is not compiled again
+ * until the service restarts.
+ */
+class ScriptCompiler
+{
+	public:
+		ScriptCompiler(const std::string& scriptsPath);
+
+		std::string
+			compile(const std::string& module);
+
+	private:
+		std::string
+			findExtension(const std::string& dir,
+				      const std::string& module);
+		static std::string
+			contentHash(const std::string& content);
+		static void
+			removeDirectory(const std::string& dir);
+		void	pruneVersions(const std::string& cacheDir,
+				      const std::string& module,
+				      const std::string& current);
+
+	private:
+		std::string	m_scriptsPath;
+		Logger		*m_logger;
+		// Cache directories of script versions that failed to compile
+		static std::set<std::string>
+				m_failed;
+		static std::mutex
+				m_failedMutex;
+};
+#endif
@@ -13,10 +13,14 @@
 #include <strings.h>
 #include <string>
 #include <iostream>
+#include <algorithm>
 
 #include <utils.h>
+#include <rapidjson/document.h>
 #include <pyruntime.h>
 #include "notify_python35.h"
+#include "http_helper.h"
+#include "script_compiler.h"
 
 #define SCRIPT_NAME  "notify35"
 #define PYTHON_SCRIPT_METHOD_PREFIX "_script_"
@@ -24,6 +28,7 @@
 #define SCRIPT_CONFIG_ITEM_NAME "script"
 
 using namespace std;
+using namespace rapidjson;
 
 /**
  * NotifyPython35 class constructor
@@ -38,6 +43,17 @@ NotifyPython35::NotifyPython35(ConfigCategory *category)
 	m_pythonScript = string("");
 	m_failedScript = false;
 	m_execCount = 0;
+	m_backgroundImport = false;
+	m_importTimeout = DEFAULT_IMPORT_WAIT_TIMEOUT;
+	m_ready = false;
+	m_trace = NULL;
+	m_maxConcurrency = 1;
+	m_inFlight = 0;
+	m_configGeneration = 0;
+	m_gcMode = DEFAULT_GC_MODE;
+	m_gcIdleInterval = DEFAULT_GC_IDLE_INTERVAL;
+	m_gc = NULL;
+	m_compileScript = false;
 
 	m_name = category->getName();
 
@@ -50,6 +66,51 @@ NotifyPython35::NotifyPython35(ConfigCategory *category)
 			    category->getValue("enable").compare("True") == 0;
 	}
 
+	// Set the background import flag and its wait timeout
+	if (category->itemExists("backgroundImport"))
+	{
+		m_backgroundImport = category->getValue("backgroundImport").compare("true") == 0 ||
+				     category->getValue("backgroundImport").compare("True") == 0;
+	}
+	if (category->itemExists("importWaitTimeout"))
+	{
+		long timeout = strtol(category->getValue("importWaitTimeout").c_str(), NULL, 10);
+		if (timeout >= 0)
+		{
+			m_importTimeout = timeout;
+		}
+	}
+
+	if (category->itemExists("maxConcurrency"))
+	{
+		m_maxConcurrency = max(1, atoi(category->getValue("maxConcurrency").c_str()));
+	}
+
+	if (category->itemExists("traceFile"))
+	{
+		setTraceFile(category->getValue("traceFile"));
+	}
+
+	if (category->itemExists("compileScript"))
+	{
+		m_compileScript = category->getValue("compileScript").compare("true") == 0 ||
+				  category->getValue("compileScript").compare("True") == 0;
+	}
+
+	if (category->itemExists("pipeline"))
+	{
+		setStages(category->getValue("pipeline"));
+	}
+
+	if (category->itemExists("gcMode"))
+	{
+		m_gcMode = category->getValue("gcMode");
+	}
+	if (category->itemExists("gcIdleInterval"))
+	{
+		m_gcIdleInterval = atol(category->getValue("gcIdleInterval").c_str());
+	}
+
 	// Check whether we have a Python 3.5 script file to import
 	if (category->itemExists(SCRIPT_CONFIG_ITEM_NAME))
 	{
@@ -91,6 +152,78 @@ NotifyPython35::NotifyPython35(ConfigCategory *category)
  */
 NotifyPython35::~NotifyPython35()
 {
+	if (m_importThread.joinable())
+	{
+		m_importThread.join();
+	}
+	delete m_trace;
+	delete m_gc;
+}
+
+/**
+ * Start, stop or change idle garbage collection
+ * from the current garbage collection settings
+ *
+ * This method must not be called while holding the GIL
+ */
+void NotifyPython35::setGarbageCollection()
+{
+	bool idle = m_gcMode.compare("idle") == 0;
+
+	if (m_gc && idle && m_gc->getIdleInterval() == m_gcIdleInterval)
+	{
+		return;
+	}
+
+	delete m_gc;
+	m_gc = NULL;
+
+	if (idle)
+	{
+		m_gc = new PythonGC(m_name, m_gcIdleInterval);
+	}
+}
+
+/**
+ * Start, stop or change the capture of deliveries
+ *
+ * This method must be called while holding the configuration mutex
+ * once the plugin is running
+ *
+ * @param fileName	The trace file, empty to stop capture
+ */
+void NotifyPython35::setTraceFile(const string& fileName)
+{
+	string path = fileName;
+	if (!path.empty() && path[0] != '/')
+	{
+		path = getDataDir() + "/" + path;
+	}
+
+	if (m_trace && m_trace->getFileName().compare(path) == 0)
+	{
+		return;
+	}
+
+	delete m_trace;
+	m_trace = NULL;
+
+	if (!path.empty())
+	{
+		m_trace = new DeliveryTraceWriter(path);
+		if (!m_trace->isOpen())
+		{
+			delete m_trace;
+			m_trace = NULL;
+		}
+		else
+		{
+			m_logger->info("Notification plugin '%s' (%s), capturing deliveries to '%s'",
+					PLUGIN_NAME,
+					this->getName().c_str(),
+					path.c_str());
+		}
+	}
 }
 
 /**
@@ -148,8 +281,8 @@ bool NotifyPython35::configure()
 		// Force disable
 		this->disableDelivery();
 
-		m_pModule = NULL;
-		m_pFunc = NULL;
+		Py_CLEAR(m_pModule);
+		Py_CLEAR(m_pFunc);
 
 		return true;
 	}
@@ -157,7 +290,7 @@ bool NotifyPython35::configure()
 	// 2) Import Python script if module object is not set
 	if (!m_pModule)
 	{
-		m_pModule = PyImport_ImportModule(m_pythonScript.c_str());
+		m_pModule = importScript(m_pythonScript, false);
 	}
 
 	// Check whether the Python module has been imported
@@ -181,6 +314,7 @@ bool NotifyPython35::configure()
 	}
 
 	// Fetch filter method in loaded object
+	Py_CLEAR(m_pFunc);
 	m_pFunc = PyObject_GetAttrString(m_pModule, filterMethod.c_str());
 	if (!PyCallable_Check(m_pFunc))
 	{
@@ -205,9 +339,306 @@ bool NotifyPython35::configure()
 		return false;
 	}
 
+	// Import the pipeline stages
+	if (!importStages())
+	{
+		Py_CLEAR(m_pModule);
+		Py_CLEAR(m_pFunc);
+
+		m_failedScript = true;
+
+		return false;
+	}
+
+	// Keep the imported script out of idle collections
+	if (m_gc)
+	{
+		m_gc->freeze();
+	}
+
+	return true;
+}
+
+/**
+ * Set the pipeline stages from the pipeline configuration item,
+ * a JSON document with a "stages" array of script file names.
+ * The stages are imported by the next configure.
+ *
+ * The method each stage calls is the part of its file name after
+ * _script_, or the file name itself, without the .py extension.
+ *
+ * @param pipeline	The pipeline configuration
+ */
+void NotifyPython35::setStages(const string& pipeline)
+{
+	m_newStages.clear();
+
+	Document doc;
+	doc.Parse(pipeline.c_str());
+	if (doc.HasParseError() ||
+	    !doc.IsObject() ||
+	    !doc.HasMember("stages") ||
+	    !doc["stages"].IsArray())
+	{
+		m_logger->error("Notification plugin '%s' (%s), the pipeline "
+				"configuration must have a 'stages' array of script names",
+				PLUGIN_NAME,
+				this->getName().c_str());
+		return;
+	}
+
+	const Value& stages = doc["stages"];
+	for (Value::ConstValueIterator itr = stages.Begin(); itr != stages.End(); ++itr)
+	{
+		if (!itr->IsString())
+		{
+			continue;
+		}
+
+		// Just take file name and remove path and .py
+		string script = itr->GetString();
+		std::size_t found = script.find_last_of("/");
+		if (found != std::string::npos)
+		{
+			script = script.substr(found + 1);
+		}
+		found = script.rfind(PYTHON_SCRIPT_FILENAME_EXTENSION);
+		if (found != std::string::npos)
+		{
+			script.replace(found, strlen(PYTHON_SCRIPT_FILENAME_EXTENSION), "");
+		}
+		if (script.empty())
+		{
+			continue;
+		}
+
+		string method = script;
+		found = script.rfind(PYTHON_SCRIPT_METHOD_PREFIX);
+		if (found != std::string::npos)
+		{
+			method = script.substr(found + strlen(PYTHON_SCRIPT_METHOD_PREFIX));
+		}
+
+		m_newStages.push_back(ScriptStage(script, method));
+	}
+}
+
+/**
+ * Import the configured pipeline stages, replacing the loaded ones.
+ * Stages already loaded are reloaded to pick up script changes.
+ *
+ * This method must be called while holding the configuration mutex
+ * and the GIL
+ *
+ * @return	True on success, false on errors.
+ */
+bool NotifyPython35::importStages()
+{
+	vector<ScriptStage> stages = m_newStages;
+
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		ScriptStage& stage = stages[i];
+
+		// Reload a stage module loaded by a previous configuration
+		PyObject* loaded = NULL;
+		for (size_t j = 0; j < m_stages.size() && !loaded; j++)
+		{
+			if (m_stages[j].m_script.compare(stage.m_script) == 0)
+			{
+				loaded = m_stages[j].m_pModule;
+			}
+		}
+		stage.m_pModule = importScript(stage.m_script, loaded != NULL);
+
+		if (stage.m_pModule)
+		{
+			stage.m_pFunc = PyObject_GetAttrString(stage.m_pModule,
+							       stage.m_method.c_str());
+		}
+
+		if (!PyCallable_Check(stage.m_pFunc))
+		{
+			if (PyErr_Occurred())
+			{
+				logErrorMessage(stage.m_script);
+			}
+			m_logger->fatal("Notification plugin %s (%s) error: cannot "
+					"load Python 3.5 method '%s' of pipeline stage '%s.py'",
+					PLUGIN_NAME,
+					this->getName().c_str(),
+					stage.m_method.c_str(),
+					stage.m_script.c_str());
+
+			// Drop the stages imported so far
+			for (size_t j = 0; j <= i; j++)
+			{
+				Py_CLEAR(stages[j].m_pModule);
+				Py_CLEAR(stages[j].m_pFunc);
+			}
+			clearStages();
+
+			return false;
+		}
+	}
+
+	clearStages();
+	m_stages = stages;
+
 	return true;
 }
 
+/**
+ * Release the loaded pipeline stages
+ *
+ * This method must be called while holding the GIL
+ */
+void NotifyPython35::clearStages()
+{
+	for (size_t i = 0; i < m_stages.size(); i++)
+	{
+		Py_CLEAR(m_stages[i].m_pModule);
+		Py_CLEAR(m_stages[i].m_pFunc);
+	}
+	m_stages.clear();
+}
+
+/**
+ * Pass the value returned by the main script through the pipeline
+ * stages, each stage is called with the value returned by the
+ * previous one. A None or False value ends the pipeline.
+ *
+ * This method must be called while holding the GIL
+ *
+ * @param value		The main script return value, the reference is stolen
+ * @param stages	The pipeline stages
+ * @param scriptName	Set to the failing stage script on errors
+ * @return		The last value returned, NULL on errors
+ */
+PyObject* NotifyPython35::runStages(PyObject* value,
+				    const vector<ScriptStage>& stages,
+				    string& scriptName)
+{
+	for (size_t i = 0; i < stages.size() && value; i++)
+	{
+		if (value == Py_None || value == Py_False)
+		{
+			break;
+		}
+
+		PyObject* next = PyObject_CallFunctionObjArgs(stages[i].m_pFunc, value, NULL);
+		Py_DECREF(value);
+		value = next;
+
+		if (!value)
+		{
+			scriptName = stages[i].m_script;
+		}
+	}
+
+	return value;
+}
+
+/**
+ * Import a script module, compiled if script compilation is set
+ *
+ * A script that can not be compiled is imported from source and
+ * reloaded, in case an older version was loaded before.
+ *
+ * This method must be called while holding the configuration mutex
+ * and the GIL
+ *
+ * @param script	The script module name
+ * @param reload	Reload the source module to pick up changes
+ * @return		New reference to the module, NULL on errors
+ */
+PyObject* NotifyPython35::importScript(const string& script, bool reload)
+{
+	PyObject* module = NULL;
+
+	if (m_compileScript)
+	{
+		module = importCompiled(script);
+	}
+
+	if (!module)
+	{
+		module = PyImport_ImportModule(script.c_str());
+		if (module && (reload || m_compileScript))
+		{
+			PyObject* reloaded = PyImport_ReloadModule(module);
+			Py_DECREF(module);
+			module = reloaded;
+		}
+	}
+
+	return module;
+}
+
+/**
+ * Compile a script and load the extension module
+ *
+ * The module is not added to sys.modules, a later change of the
+ * script loads the extension module compiled from the new content.
+ *
+ * This method must be called while holding the configuration mutex
+ * and the GIL
+ *
+ * @param script	The script module name
+ * @return		New reference to the module, NULL on errors
+ */
+PyObject* NotifyPython35::importCompiled(const string& script)
+{
+	ScriptCompiler compiler(m_scriptsPath);
+	string extension;
+
+	// Other threads run Python while the compiler runs
+	Py_BEGIN_ALLOW_THREADS
+	extension = compiler.compile(script);
+	Py_END_ALLOW_THREADS
+
+	if (extension.empty())
+	{
+		return NULL;
+	}
+
+	// Load with importlib, as the compiled module is not in sys.path
+	PyObject* module = NULL;
+	PyObject* util = PyImport_ImportModule("importlib.util");
+	PyObject* spec = util ? PyObject_CallMethod(util,
+						    "spec_from_file_location",
+						    "ss",
+						    script.c_str(),
+						    extension.c_str()) : NULL;
+	if (spec && spec != Py_None)
+	{
+		module = PyObject_CallMethod(util, "module_from_spec", "O", spec);
+	}
+	PyObject* loader = module ? PyObject_GetAttrString(spec, "loader") : NULL;
+	PyObject* pReturn = loader ? PyObject_CallMethod(loader, "exec_module", "O", module) : NULL;
+
+	if (!pReturn)
+	{
+		if (PyErr_Occurred())
+		{
+			logErrorMessage(script);
+		}
+		m_logger->warn("Notification plugin '%s' (%s), unable to load compiled "
+				"script '%s', using the plain script",
+				PLUGIN_NAME,
+				this->getName().c_str(),
+				extension.c_str());
+		Py_CLEAR(module);
+	}
+
+	Py_XDECREF(pReturn);
+	Py_XDECREF(loader);
+	Py_XDECREF(spec);
+	Py_XDECREF(util);
+
+	return module;
+}
+
 /**
  * Reconfigure the delivery plugin
  *
@@ -225,6 +656,50 @@ bool NotifyPython35::reconfigure(const std::string& newConfig)
 	// Configuration change is protected by a lock
 	lock_guard<mutex> guard(m_configMutex);
 
+	// Calls still running under the previous configuration
+	// must not mark the new one as failed
+	m_configGeneration++;
+
+	// A pending background import is superseded by this configuration
+	if (!isReady())
+	{
+		setReady();
+	}
+
+	if (category.itemExists("maxConcurrency"))
+	{
+		m_maxConcurrency = max(1, atoi(category.getValue("maxConcurrency").c_str()));
+		m_slotCond.notify_all();
+	}
+
+	if (category.itemExists("traceFile"))
+	{
+		setTraceFile(category.getValue("traceFile"));
+	}
+
+	// Compiled modules are not in sys.modules and can not be reloaded
+	bool wasCompiled = m_compileScript;
+	if (category.itemExists("compileScript"))
+	{
+		m_compileScript = category.getValue("compileScript").compare("true") == 0 ||
+				  category.getValue("compileScript").compare("True") == 0;
+	}
+
+	if (category.itemExists("pipeline"))
+	{
+		setStages(category.getValue("pipeline"));
+	}
+
+	if (category.itemExists("gcMode"))
+	{
+		m_gcMode = category.getValue("gcMode");
+	}
+	if (category.itemExists("gcIdleInterval"))
+	{
+		m_gcIdleInterval = atol(category.getValue("gcIdleInterval").c_str());
+	}
+	setGarbageCollection();
+
 	PyGILState_STATE state = PyGILState_Ensure(); // acquire GIL
 
 	// Get Python script file from "file" attibute of "scipt" item
@@ -278,7 +753,22 @@ bool NotifyPython35::reconfigure(const std::string& newConfig)
 	}
 
 	// Reload module or Import module ?
-	if (newScript.compare(m_pythonScript) == 0 && m_pModule)
+	if (m_compileScript || wasCompiled)
+	{
+		m_failedScript = false;
+		m_execCount = 0;
+
+		// Cleanup Loaded module
+		Py_CLEAR(m_pModule);
+		Py_CLEAR(m_pFunc);
+
+		// Set new name
+		m_pythonScript = newScript;
+
+		// Load the module compiled from the current script, or reload the source
+		m_pModule = importScript(m_pythonScript, true);
+	}
+	else if (newScript.compare(m_pythonScript) == 0 && m_pModule)
 	{
 		m_failedScript = false;
 		m_execCount = 0;
@@ -363,7 +853,7 @@ bool NotifyPython35::notify(const std::string& deliveryName,
 			    const string& triggerReason,
 			    const string& customMessage)
 {
-	lock_guard<mutex> guard(m_configMutex);
+	unique_lock<mutex> guard(m_configMutex);
 	bool ret = false;
 
         if (!m_enabled)
@@ -372,6 +862,12 @@ bool NotifyPython35::notify(const std::string& deliveryName,
                 return false;
         }
 
+	// Defer idle garbage collection
+	if (m_gc)
+	{
+		m_gc->activity();
+	}
+
 	if (m_failedScript)
 	{
 		// Just log once
@@ -395,6 +891,9 @@ bool NotifyPython35::notify(const std::string& deliveryName,
 		return false;
 	}
 
+#ifdef PYTHON_FREE_THREADED
+	return notifyConcurrent(guard, customMessage);
+#else
 	PyGILState_STATE state = PyGILState_Ensure();
 
 	// Save configuration variables and Python objects
@@ -402,11 +901,19 @@ bool NotifyPython35::notify(const std::string& deliveryName,
 	string scriptName = m_pythonScript;
 	PyObject* method = m_pFunc;
 
+	// Count HTTP requests of the script against this instance
+	HttpHelper::setOwner(this);
+
 	// Call Python method passing an object
 	PyObject* pReturn = PyObject_CallFunction(method,
 						  "s",
 						  customMessage.c_str());
 
+	// Pass the result through the pipeline stages
+	pReturn = runStages(pReturn, m_stages, scriptName);
+
+	HttpHelper::setOwner(NULL);
+
 	// Check return status
 	if (!pReturn)
 	{
@@ -417,7 +924,7 @@ bool NotifyPython35::notify(const std::string& deliveryName,
 				   scriptName.c_str());
 
 		// Errors while getting result object
-		logErrorMessage();
+		logErrorMessage(scriptName);
 
 		// Mark failure to reduce excessive logging
 		m_failedScript = true;
@@ -438,14 +945,137 @@ bool NotifyPython35::notify(const std::string& deliveryName,
 
 	PyGILState_Release(state);
 
+	return ret;
+#endif
+}
+
+#ifdef PYTHON_FREE_THREADED
+/**
+ * Call Python notification method without holding the configuration
+ * mutex, so that up to m_maxConcurrency calls run in parallel.
+ *
+ * The mutex is never waited on while the thread state is attached:
+ * that would block the stop-the-world pauses of a free-threaded
+ * interpreter.
+ *
+ * @param guard		The held configuration lock
+ * @param message	The message to send
+ */
+bool NotifyPython35::notifyConcurrent(unique_lock<mutex>& guard,
+				      const string& customMessage)
+{
+	// Wait for a free delivery slot
+	m_slotCond.wait(guard, [this] { return m_inFlight < m_maxConcurrency; });
+
+	// Configuration may have changed while waiting
+	if (!m_enabled || m_failedScript || !m_pFunc)
+	{
+		return false;
+	}
+
+	m_inFlight++;
+
+	// Save configuration variables and Python objects
+	string name = m_name;
+	string scriptName = m_pythonScript;
+	unsigned long generation = m_configGeneration;
+
+	PyGILState_STATE state = PyGILState_Ensure();
+
+	// Keep the method and stages alive across a reconfiguration
+	PyObject* method = m_pFunc;
+	Py_INCREF(method);
+	vector<ScriptStage> stages = m_stages;
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		Py_INCREF(stages[i].m_pFunc);
+	}
+
+	guard.unlock();
+
+	bool ret = false;
+
+	// Count HTTP requests of the script against this instance
+	HttpHelper::setOwner(this);
+
+	// Call Python method passing an object
+	PyObject* pReturn = PyObject_CallFunction(method,
+						  "s",
+						  customMessage.c_str());
+
+	// Pass the result through the pipeline stages
+	pReturn = runStages(pReturn, stages, scriptName);
+
+	HttpHelper::setOwner(NULL);
+
+	// Check return status
+	if (!pReturn)
+	{
+		// Errors while getting result object
+		m_logger->error("Notification plugin '%s' (%s), error in script '%s'",
+				   PLUGIN_NAME,
+				   name.c_str(),
+				   scriptName.c_str());
+
+		// Errors while getting result object
+		logErrorMessage(scriptName);
+	}
+	else
+	{
+		ret = true;
+		m_logger->debug("PyObject_CallFunction() succeeded");
+
+		// Remove pReturn object
+		Py_CLEAR(pReturn);
+	}
+
+	Py_DECREF(method);
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		Py_DECREF(stages[i].m_pFunc);
+	}
+
+	PyGILState_Release(state);
+
+	guard.lock();
+
+	if (!ret && generation == m_configGeneration)
+	{
+		// Mark failure to reduce excessive logging
+		m_failedScript = true;
+	}
+
+	m_inFlight--;
+	m_slotCond.notify_one();
+
+	m_logger->debug("Notification '%s' 'plugin_delivery' " \
+			   "called, return = %d",
+			   name.c_str(),
+			   ret);
+
 	return ret;
 }
+#endif
 
 /**
  * Shutdown the Python35 notification plugin
  */
 void NotifyPython35::shutdown()
 {
+	// Wait for a background import still in progress
+	if (m_importThread.joinable())
+	{
+		m_importThread.join();
+	}
+
+	// Stop idle garbage collection before taking the GIL
+	delete m_gc;
+	m_gc = NULL;
+
+	// Complete background HTTP requests of this instance
+	HttpHelper::getInstance()->waitPending(this, HTTP_HELPER_SHUTDOWN_WAIT);
+	HttpHelper::getInstance()->logStatistics();
+
 	PyGILState_STATE state = PyGILState_Ensure();
 
 	// Decrement pModule reference count
@@ -454,12 +1084,25 @@ void NotifyPython35::shutdown()
 	// Decrement pFunc reference count
 	Py_CLEAR(m_pFunc);
 
+	// Release pipeline stages
+	clearStages();
+
 	// Interpreter is still running, just release the GIL
 	PyGILState_Release(state); // release GIL
 }
 
+/**
+ * Initialise the Python runtime and import the script
+ *
+ * If background import is set the script is imported by a separate
+ * thread and deliveries wait for it, up to the import wait timeout.
+ *
+ * @return	True on success, false on errors.
+ */
 bool NotifyPython35::init()
 {
+	m_initStart = chrono::steady_clock::now();
+
 	// Embedded Python 3.5 program name
 	wchar_t *programName = Py_DecodeLocale(m_name.c_str(), NULL);
 	Py_SetProgramName(programName);
@@ -468,6 +1111,8 @@ bool NotifyPython35::init()
 	// Embedded Python 3.5 initialisation
 	PythonRuntime::getPythonRuntime();
 
+	setGarbageCollection();
+
 	PyGILState_STATE state = PyGILState_Ensure(); // acquire GIL
 
 	// Add scripts dir: pass Fledge Data dir
@@ -478,10 +1123,23 @@ bool NotifyPython35::init()
 	PyObject* sysPath = PySys_GetObject((char *)string("path").c_str());
 	// Add Fledge python scripts path
 	PyObject* pPath = PyUnicode_DecodeFSDefault((char *)this->getScriptsPath().c_str());
-	PyList_Insert(sysPath, 0, pPath);
+	// Add it once, the plugin may be loaded many times
+	if (PySequence_Contains(sysPath, pPath) != 1)
+	{
+		PyList_Insert(sysPath, 0, pPath);
+	}
 	// Remove temp object
 	Py_CLEAR(pPath);
 
+	// Make the HTTP helper module available to scripts
+	if (!HttpHelper::registerModule())
+	{
+		m_logger->warn("Notification plugin '%s' (%s), unable to add the '%s' module",
+				PLUGIN_NAME,
+				this->getName().c_str(),
+				HTTP_HELPER_MODULE);
+	}
+
 	// Check first we have a Python script to load
 	if (this->getScriptName().empty())
 	{
@@ -489,9 +1147,20 @@ bool NotifyPython35::init()
 		this->disableDelivery();
 	}
 
+	if (m_backgroundImport)
+	{
+		PyGILState_Release(state); // release GIL
+
+		// Return the handle now, import the script later
+		m_importThread = thread(&NotifyPython35::backgroundImport, this);
+
+		return true;
+	}
+
 	// Configure plugin
 	this->lock();
 	bool ret = this->configure();
+	setReady();
 	this->unlock();
 
 	PyGILState_Release(state); // release GIL
@@ -499,11 +1168,104 @@ bool NotifyPython35::init()
 	return ret;
 }
 
+/**
+ * Import the script on the background import thread
+ */
+void NotifyPython35::backgroundImport()
+{
+	// Configuration lock first, then the GIL, as in reconfigure
+	lock_guard<mutex> guard(m_configMutex);
+
+	// Script already loaded by a reconfiguration
+	if (isReady())
+	{
+		return;
+	}
+
+	PyGILState_STATE state = PyGILState_Ensure(); // acquire GIL
+
+	if (!this->configure())
+	{
+		m_logger->error("Notification plugin '%s' (%s), background import of "
+				"Python script '%s' has failed",
+				PLUGIN_NAME,
+				this->getName().c_str(),
+				m_pythonScript.c_str());
+	}
+
+	PyGILState_Release(state); // release GIL
+
+	setReady();
+}
+
+/**
+ * Mark the script import as complete, log the startup time
+ * and wake up any waiting delivery.
+ *
+ * This method must be called while holding the configuration mutex
+ */
+void NotifyPython35::setReady()
+{
+	long startupTime = chrono::duration_cast<chrono::milliseconds>
+				(chrono::steady_clock::now() - m_initStart).count();
+	{
+		lock_guard<mutex> guard(m_readyMutex);
+		m_ready = true;
+	}
+
+	m_logger->info("Notification plugin '%s' (%s) startup time %ld ms",
+			PLUGIN_NAME,
+			this->getName().c_str(),
+			startupTime);
+
+	m_readyCond.notify_all();
+}
+
+/**
+ * Return whether the script import has completed
+ */
+bool NotifyPython35::isReady()
+{
+	lock_guard<mutex> guard(m_readyMutex);
+	return m_ready;
+}
+
+/**
+ * Wait for a background script import to complete,
+ * up to the import wait timeout
+ *
+ * This method must be called without holding the configuration
+ * mutex, which the background import holds while importing.
+ *
+ * @return	False if the import has not completed in time
+ */
+bool NotifyPython35::waitForImport()
+{
+	unique_lock<mutex> guard(m_readyMutex);
+	if (m_ready ||
+	    m_readyCond.wait_for(guard,
+				 chrono::milliseconds(m_importTimeout),
+				 [this] { return m_ready; }))
+	{
+		return true;
+	}
+	guard.unlock();
+
+	m_logger->warn("The '%s' notification has not completed the import " \
+			"of its Python script within %ld ms, " \
+			"notification has not been delivered",
+			m_name.c_str(),
+			m_importTimeout);
+
+	return false;
+}
+
 /**
  * Log current Python 3.5 error message
  *
+ * @param scriptName	The script the error comes from
  */
-void NotifyPython35::logErrorMessage()
+void NotifyPython35::logErrorMessage(const string& scriptName)
 {
 	if (PyErr_Occurred())
 	{
@@ -512,23 +1274,21 @@ void NotifyPython35::logErrorMessage()
 		PyErr_Fetch(&ptype, &pvalue, &ptraceback);
 		PyErr_NormalizeException(&ptype,&pvalue,&ptraceback);
 
-		char *msg, *file, *text;
-		int line, offset;
-
-		int res = PyArg_ParseTuple(pvalue,"s(siis)",&msg,&file,&line,&offset,&text);
-
+		// Only syntax errors have lineno and text attributes
 		PyObject *line_no = PyObject_GetAttrString(pvalue,"lineno");
+		PyErr_Clear();
 		PyObject *line_no_str = PyObject_Str(line_no);
 		PyObject *line_no_unicode = PyUnicode_AsEncodedString(line_no_str,"utf-8", "Error");
 		char *actual_line_no = PyBytes_AsString(line_no_unicode);  // Line number
 
 		PyObject *ptext = PyObject_GetAttrString(pvalue,"text");
+		PyErr_Clear();
 		PyObject *ptext_str = PyObject_Str(ptext);
 		PyObject *ptext_no_unicode = PyUnicode_AsEncodedString(ptext_str,"utf-8", "Error");
 		char *error_line = PyBytes_AsString(ptext_no_unicode);  // Line in error
 
 		// Remove the trailing newline from the string
-		char *newline = rindex(error_line,  '\n');
+		char *newline = error_line ? rindex(error_line,  '\n') : NULL;
 		if (newline)
 		{
 			*newline = '\0';
@@ -558,7 +1318,7 @@ void NotifyPython35::logErrorMessage()
 		{
 			m_logger->error("Python error: %s in supplied script '%s'",
 					err_msg,
-					m_pythonScript.c_str());
+					scriptName.c_str());
 		}
 		else
 		{
@@ -566,7 +1326,7 @@ void NotifyPython35::logErrorMessage()
 					err_msg,
 					error_line,
 					actual_line_no,
-					m_pythonScript.c_str());
+					scriptName.c_str());
 		}
 
 		// Reset error
@@ -64,6 +64,65 @@ static const char *default_config = QUOTE({
 		"displayName" : "Python script",
 		"order" : "1",
 		"default": ""
+		},
+	"backgroundImport": {
+		"description": "Import the Python script on a background thread so that the start of the notification service is not delayed by slow script imports.",
+		"type": "boolean",
+		"displayName" : "Background Import",
+		"order" : "4",
+		"default": "false"
+		},
+	"importWaitTimeout": {
+		"description": "Maximum time in milliseconds a notification waits for a background script import to complete before it is discarded.",
+		"type": "integer",
+		"displayName" : "Import Wait Timeout",
+		"order" : "5",
+		"default": "5000"
+		},
+	"traceFile": {
+		"description": "File to which every delivery is appended so that it can be replayed later. A relative path is under the Fledge data directory. Leave empty to disable capture.",
+		"type": "string",
+		"displayName" : "Delivery Trace File",
+		"order" : "6",
+		"default": ""
+		},
+	"maxConcurrency": {
+		"description": "Maximum number of notifications delivered by the script at the same time. Only used with a free-threaded Python build, the script must be thread safe for values greater than 1.",
+		"type": "integer",
+		"displayName" : "Maximum Concurrency",
+		"order" : "7",
+		"default": "1",
+		"minimum": "1"
+		},
+	"gcMode": {
+		"description": "Python garbage collection: automatic, or run when deliveries are idle with the objects of the loaded script frozen out of collection.",
+		"type": "enumeration",
+		"options": [ "automatic", "idle" ],
+		"displayName" : "Garbage Collection",
+		"order" : "8",
+		"default": "automatic"
+		},
+	"gcIdleInterval": {
+		"description": "Seconds without deliveries after which an idle garbage collection is run.",
+		"type": "integer",
+		"displayName" : "Garbage Collection Idle Interval",
+		"order" : "9",
+		"default": "10",
+		"minimum": "1"
+		},
+	"pipeline" : {
+		"description" : "Further scripts, from the scripts directory, to pass the return value of the Python script through in order. A stage that returns None or False ends the pipeline.",
+		"type" : "JSON",
+		"displayName" : "Script Pipeline",
+		"order" : "10",
+		"default" : "{ \"stages\" : [] }"
+		},
+	"compileScript": {
+		"description": "Compile the Python script, and pipeline stages, into native extension modules with Cython. The plain script is used if compilation fails.",
+		"type": "boolean",
+		"displayName" : "Compile Script",
+		"order" : "11",
+		"default": "false"
 		}
 	});
 
@@ -135,9 +194,21 @@ bool plugin_deliver(PLUGIN_HANDLE handle,
 {
 	NotifyPython35* notify = (NotifyPython35 *) handle;
 
+	// Wait for a background script import, without blocking
+	// on the configuration lock it holds
+	if (!notify->waitForImport())
+	{
+		return false;
+	}
+
 	// Protect against reconfiguration
 	notify->lock();
 	bool enabled = notify->isEnabled();
+	// Capture delivery for later replay
+	notify->trace(deliveryName,
+		      notificationName,
+		      triggerReason,
+		      message);
 	notify->unlock();
 
 	if (!enabled)
@@ -0,0 +1,199 @@
+/*
+ * Fledge "Python 3.5" notification plugin garbage collection scheduling.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include "python_gc.h"
+
+using namespace std;
+
+int PythonGC::m_instances = 0;
+mutex PythonGC::m_instancesMutex;
+
+/**
+ * PythonGC constructor
+ *
+ * Disable automatic collection and start the idle collection thread
+ *
+ * @param name		The delivery category name, for logging
+ * @param idleInterval	Seconds without deliveries before a collection
+ */
+PythonGC::PythonGC(const string& name, long idleInterval) :
+			m_name(name),
+			m_idleInterval(idleInterval > 0 ? idleInterval : 1),
+			m_stop(false),
+			m_collections(0),
+			m_collected(0),
+			m_totalPause(0),
+			m_maxPause(0)
+{
+	m_logger = Logger::getLogger();
+	activity();
+	m_lastCollection = chrono::steady_clock::now();
+
+	{
+		// There is no GIL to protect the count on free-threaded builds
+		lock_guard<mutex> guard(m_instancesMutex);
+		if (m_instances++ == 0)
+		{
+			PyGILState_STATE state = PyGILState_Ensure();
+			callCollector("disable");
+			PyGILState_Release(state);
+		}
+	}
+
+	m_thread = thread(&PythonGC::run, this);
+}
+
+/**
+ * PythonGC destructor
+ *
+ * Stop the collection thread, report statistics and enable
+ * automatic collection again if this is the last instance.
+ */
+PythonGC::~PythonGC()
+{
+	{
+		lock_guard<mutex> guard(m_mutex);
+		m_stop = true;
+	}
+	m_cond.notify_all();
+	m_thread.join();
+
+	{
+		lock_guard<mutex> guard(m_instancesMutex);
+		if (--m_instances == 0)
+		{
+			PyGILState_STATE state = PyGILState_Ensure();
+			callCollector("unfreeze");
+			callCollector("enable");
+			PyGILState_Release(state);
+		}
+	}
+
+	lock_guard<mutex> guard(m_mutex);
+	m_logger->info("Notification '%s' garbage collection: %ld collections, "
+			"%ld objects collected, total pause %.3f ms, maximum pause %.3f ms",
+			m_name.c_str(),
+			m_collections,
+			m_collected,
+			m_totalPause,
+			m_maxPause);
+}
+
+/**
+ * Move all objects to the permanent generation, they are not
+ * scanned by later collections
+ *
+ * Objects frozen by an earlier import are unfrozen and collected
+ * first: the module a reload replaces is only garbage once it has
+ * been dropped, and collections do not scan the permanent generation.
+ */
+void PythonGC::freeze()
+{
+	PyGILState_STATE state = PyGILState_Ensure();
+	callCollector("unfreeze");
+	collect();
+	callCollector("freeze");
+	PyGILState_Release(state);
+}
+
+/**
+ * Idle collection thread
+ */
+void PythonGC::run()
+{
+	chrono::seconds interval(m_idleInterval);
+	unique_lock<mutex> guard(m_mutex);
+
+	while (!m_cond.wait_for(guard, interval, [this] { return m_stop; }))
+	{
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		chrono::steady_clock::time_point last((chrono::steady_clock::duration(m_lastActivity.load())));
+
+		// Idle since deliveries made after the last collection, or deferred too long
+		if ((now - last >= interval && last > m_lastCollection) ||
+		    now - m_lastCollection >= interval * GC_MAX_DEFERRED_INTERVALS)
+		{
+			// Do not hold the lock while waiting for the GIL
+			guard.unlock();
+			collect();
+			guard.lock();
+		}
+	}
+}
+
+/**
+ * Run a full collection and record its pause time
+ */
+void PythonGC::collect()
+{
+	PyGILState_STATE state = PyGILState_Ensure();
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long collected = 0;
+
+	PyObject* gcModule = PyImport_ImportModule("gc");
+	PyObject* pReturn = gcModule ? PyObject_CallMethod(gcModule, "collect", NULL) : NULL;
+	if (pReturn)
+	{
+		collected = PyLong_AsLong(pReturn);
+	}
+	else
+	{
+		PyErr_Clear();
+	}
+	Py_XDECREF(pReturn);
+	Py_XDECREF(gcModule);
+
+	double pause = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	PyGILState_Release(state);
+
+	lock_guard<mutex> guard(m_mutex);
+	m_lastCollection = chrono::steady_clock::now();
+	m_collections++;
+	m_collected += collected;
+	m_totalPause += pause;
+	if (pause > m_maxPause)
+	{
+		m_maxPause = pause;
+	}
+
+	m_logger->debug("Notification '%s' garbage collection: %ld objects collected in %.3f ms",
+			m_name.c_str(),
+			collected,
+			pause);
+}
+
+/**
+ * Call a method of the Python gc module
+ *
+ * The GIL must be held. Methods missing from older Python
+ * versions, such as freeze, are ignored.
+ *
+ * @param method	The gc method to call
+ * @return		True if the method has been called
+ */
+bool PythonGC::callCollector(const char *method)
+{
+	bool ret = false;
+	PyObject* gcModule = PyImport_ImportModule("gc");
+
+	if (gcModule && PyObject_HasAttrString(gcModule, method))
+	{
+		PyObject* pReturn = PyObject_CallMethod(gcModule, method, NULL);
+		ret = pReturn != NULL;
+		Py_XDECREF(pReturn);
+	}
+	if (!ret)
+	{
+		PyErr_Clear();
+	}
+	Py_XDECREF(gcModule);
+
+	return ret;
+}
@@ -0,0 +1,275 @@
+/*
+ * Fledge "Python 3.5" notification plugin script compiler.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <dirent.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "script_compiler.h"
+
+using namespace std;
+
+set<string> ScriptCompiler::m_failed;
+mutex ScriptCompiler::m_failedMutex;
+
+/**
+ * ScriptCompiler constructor
+ *
+ * @param scriptsPath	The directory of the delivery scripts
+ */
+ScriptCompiler::ScriptCompiler(const string& scriptsPath) :
+				m_scriptsPath(scriptsPath)
+{
+	m_logger = Logger::getLogger();
+}
+
+/**
+ * Return the compiled extension module of a script,
+ * compiling the script if it has not been compiled yet
+ *
+ * @param module	The script module name
+ * @return		The path of the extension module, empty on errors
+ */
+string ScriptCompiler::compile(const string& module)
+{
+	// Module names are Python identifiers, anything else is not compiled
+	if (module.empty() ||
+	    module.find_first_not_of("abcdefghijklmnopqrstuvwxyz"
+				     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				     "0123456789_") != string::npos)
+	{
+		m_logger->warn("Script '%s' is not compiled, its name is not "
+				"a Python identifier, the plain script is used",
+				module.c_str());
+		return "";
+	}
+
+	string source = m_scriptsPath + "/" + module + ".py";
+	ifstream file(source.c_str());
+	if (!file)
+	{
+		m_logger->error("Unable to read script '%s' to compile", source.c_str());
+		return "";
+	}
+	stringstream content;
+	content << file.rdbuf();
+
+	string cacheDir = m_scriptsPath + COMPILED_SCRIPTS_DIR;
+	string dir = cacheDir + "/" + module + "-" + contentHash(content.str());
+
+	// Compiled already
+	string extension = findExtension(dir, module);
+	if (!extension.empty())
+	{
+		return extension;
+	}
+
+	{
+		lock_guard<mutex> guard(m_failedMutex);
+		if (m_failed.find(dir) != m_failed.end())
+		{
+			m_logger->debug("Script '%s' has failed to compile, the plain script is used",
+					source.c_str());
+			return "";
+		}
+	}
+
+	// Compile in a private directory, other instances may be
+	// compiling the same script at the same time
+	string tmpTemplate = dir + ".XXXXXX";
+	vector<char> tmpName(tmpTemplate.begin(), tmpTemplate.end());
+	tmpName.push_back('\0');
+	if ((mkdir(cacheDir.c_str(), 0755) != 0 && errno != EEXIST) ||
+	    !mkdtemp(&tmpName[0]))
+	{
+		m_logger->error("Unable to create compiled scripts directory in '%s'",
+				cacheDir.c_str());
+		return "";
+	}
+	string tmpDir(&tmpName[0]);
+
+	ofstream copy((tmpDir + "/" + module + ".py").c_str());
+	copy << content.str();
+	copy.close();
+	if (!copy)
+	{
+		m_logger->error("Unable to copy script '%s' to '%s'", source.c_str(), tmpDir.c_str());
+		removeDirectory(tmpDir);
+		return "";
+	}
+
+	string command = "cd '" + tmpDir + "' && " SCRIPT_COMPILER_COMMAND " " +
+			 module + ".py > /dev/null 2>&1";
+	int ret = system(command.c_str());
+
+	if (findExtension(tmpDir, module).empty())
+	{
+		m_logger->warn("Compilation of script '%s' has failed, status %d, "
+				"it is not compiled again until it changes or the service restarts",
+				source.c_str(),
+				ret);
+		removeDirectory(tmpDir);
+
+		lock_guard<mutex> guard(m_failedMutex);
+		m_failed.insert(dir);
+		return "";
+	}
+
+	// Publish the compiled module atomically, unless another
+	// instance has already done it
+	if (rename(tmpDir.c_str(), dir.c_str()) != 0)
+	{
+		if (findExtension(dir, module).empty())
+		{
+			// Left by an interrupted compilation, replace it
+			removeDirectory(dir);
+			if (rename(tmpDir.c_str(), dir.c_str()) != 0)
+			{
+				m_logger->error("Unable to move compiled script to '%s'",
+						dir.c_str());
+			}
+		}
+		removeDirectory(tmpDir);
+	}
+
+	extension = findExtension(dir, module);
+	if (!extension.empty())
+	{
+		m_logger->info("Script '%s' compiled to '%s'",
+				source.c_str(),
+				extension.c_str());
+
+		pruneVersions(cacheDir, module, dir);
+	}
+
+	return extension;
+}
+
+/**
+ * Remove the modules compiled from other versions of a script
+ *
+ * Private compilation directories of other instances are kept.
+ * An extension module already loaded stays mapped once removed.
+ *
+ * @param cacheDir	The compiled scripts directory
+ * @param module	The script module name
+ * @param current	The cache directory of the current version
+ */
+void ScriptCompiler::pruneVersions(const string& cacheDir,
+				   const string& module,
+				   const string& current)
+{
+	DIR *d = opendir(cacheDir.c_str());
+	if (!d)
+	{
+		return;
+	}
+
+	// Cache directories are named <module>-<16 hex digits hash>
+	string prefix = module + "-";
+	vector<string> versions;
+	struct dirent *entry;
+	while ((entry = readdir(d)) != NULL)
+	{
+		string name = entry->d_name;
+		if (name.length() == prefix.length() + 16 &&
+		    name.compare(0, prefix.length(), prefix) == 0 &&
+		    name.find_first_not_of("0123456789abcdef", prefix.length()) == string::npos &&
+		    cacheDir + "/" + name != current)
+		{
+			versions.push_back(cacheDir + "/" + name);
+		}
+	}
+	closedir(d);
+
+	for (size_t i = 0; i < versions.size(); i++)
+	{
+		m_logger->debug("Removing '%s' compiled from an earlier version of script '%s'",
+				versions[i].c_str(),
+				module.c_str());
+		removeDirectory(versions[i]);
+	}
+}
+
+/**
+ * nftw callback removing a file or an emptied directory
+ */
+static int removeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+	return remove(path);
+}
+
+/**
+ * Remove a directory and its content
+ *
+ * @param dir	The directory to remove
+ */
+void ScriptCompiler::removeDirectory(const string& dir)
+{
+	nftw(dir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+/**
+ * Find the extension module of a script in a directory
+ *
+ * @param dir		The directory to search
+ * @param module	The script module name
+ * @return		The extension module path or empty if not found
+ */
+string ScriptCompiler::findExtension(const string& dir, const string& module)
+{
+	string extension;
+	DIR *d = opendir(dir.c_str());
+	if (!d)
+	{
+		return extension;
+	}
+
+	string prefix = module + ".";
+	string suffix = ".so";
+	struct dirent *entry;
+	while ((entry = readdir(d)) != NULL && extension.empty())
+	{
+		string name = entry->d_name;
+		if (name.length() > prefix.length() + suffix.length() &&
+		    name.compare(0, prefix.length(), prefix) == 0 &&
+		    name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0)
+		{
+			extension = dir + "/" + name;
+		}
+	}
+	closedir(d);
+
+	return extension;
+}
+
+/**
+ * Return the FNV-1a 64 bit hash of the script content as hex
+ *
+ * @param content	The script content
+ */
+string ScriptCompiler::contentHash(const string& content)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < content.length(); i++)
+	{
+		hash ^= (unsigned char)content[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+
+	return string(hex);
+}
@@ -0,0 +1,242 @@
+/*
+ * Fledge "Python 3.5" notification plugin fledge_http module check.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <server_http.hpp>
+#include "http_helper.h"
+
+/**
+ * Check the fledge_http module against a local HTTP server.
+ *
+ * Usage: notify_http_check [port]
+ *
+ * A server is started on 127.0.0.1 and the given port, 8765 by
+ * default, and a Python script checks synchronous posts, callbacks,
+ * failures, an IOError once the request queue is full and the
+ * stats() counters. The server resources are:
+ *
+ *	/echo		Returns the request body
+ *	/block		Waits for /release before returning the body
+ *	/release	Releases the waiting /block requests
+ *
+ * The exit status is 0 if all the checks pass.
+ */
+
+using namespace std;
+
+typedef SimpleWeb::Server<SimpleWeb::HTTP> HttpServer;
+
+// The checks, port, workers and queueSize are set by the tool
+static const char *checks =
+	"import time, fledge_http\n"
+	"base = 'http://127.0.0.1:%d' % port\n"
+	"failures = []\n"
+	"def check(condition, text):\n"
+	"    print(('PASS ' if condition else 'FAIL ') + text)\n"
+	"    if not condition:\n"
+	"        failures.append(text)\n"
+	"results = []\n"
+	"def callback(status, body):\n"
+	"    results.append((status, body))\n"
+	"def wait(count, timeout=30):\n"
+	"    end = time.time() + timeout\n"
+	"    while len(results) < count and time.time() < end:\n"
+	"        time.sleep(0.01)\n"
+	"    return len(results) >= count\n"
+	"\n"
+	"status, body = fledge_http.post(base + '/echo', '{\"alert\": 1}')\n"
+	"check(status == 200 and body == '{\"alert\": 1}', 'post returns the status and body')\n"
+	"status, body = fledge_http.post(base + '/echo', 'second', headers={'Content-Type': 'text/plain'})\n"
+	"check(status == 200 and body == 'second', 'post with headers')\n"
+	"\n"
+	"check(fledge_http.post(base + '/echo', 'async', callback=callback) is None,\n"
+	"      'post with a callback returns None')\n"
+	"check(wait(1) and results[0] == (200, 'async'), 'callback is called with the status and body')\n"
+	"\n"
+	"for url in ('https://127.0.0.1/', 'http://[::1]:%d/' % port,\n"
+	"            'http://127.0.0.1:http/', 'http://127.0.0.1:99999/', 'http://127.0.0.1:1/'):\n"
+	"    try:\n"
+	"        fledge_http.post(url, '', timeout=2)\n"
+	"        check(False, 'IOError raised for ' + url)\n"
+	"    except IOError:\n"
+	"        check(True, 'IOError raised for ' + url)\n"
+	"\n"
+	"del results[:]\n"
+	"fledge_http.post('http://127.0.0.1:1/', '', timeout=2, callback=callback)\n"
+	"check(wait(1) and results[0][0] == 0, 'callback is called with status 0 on failure')\n"
+	"\n"
+	"del results[:]\n"
+	"queued = 0\n"
+	"full = False\n"
+	"for i in range(2 * (workers + queueSize)):\n"
+	"    try:\n"
+	"        fledge_http.post(base + '/block', str(i), callback=callback)\n"
+	"        queued += 1\n"
+	"    except IOError:\n"
+	"        full = True\n"
+	"        break\n"
+	"check(full and queued <= workers + queueSize,\n"
+	"      'IOError raised once the queue is full, after %d requests' % queued)\n"
+	"fledge_http.post(base + '/release', '')\n"
+	"check(wait(queued), 'callbacks of all the queued requests are called')\n"
+	"check(all(r[0] == 200 for r in results), 'queued requests succeed')\n"
+	"\n"
+	"stats = fledge_http.stats()\n"
+	"local = stats.get('127.0.0.1:%d' % port, {})\n"
+	"check(local.get('requests') == queued + 4, 'requests counted, %s' % local.get('requests'))\n"
+	"check(local.get('failures') == 0, 'no failures counted')\n"
+	"check(local.get('pooled', 0) > 0, 'pooled clients counted')\n"
+	"check(local.get('max_ms', -1) >= local.get('average_ms', 0) > 0, 'latencies recorded')\n"
+	"closed = stats.get('127.0.0.1:1', {})\n"
+	"check(closed.get('requests') == 2 and closed.get('failures') == 2,\n"
+	"      'failures counted against the endpoint')\n"
+	"check(len(stats) == 2, 'invalid URLs are not counted')\n";
+
+// Held /block requests
+static mutex blockMutex;
+static condition_variable blockCond;
+static bool released = false;
+
+/**
+ * Send a 200 response
+ */
+static void reply(shared_ptr<HttpServer::Response> response, const string& content)
+{
+	*response << "HTTP/1.1 200 OK\r\nContent-Length: " << content.length() << "\r\n\r\n" << content;
+}
+
+/**
+ * Wait for the server to accept connections
+ */
+static bool waitListening(unsigned short port)
+{
+	for (int i = 0; i < 100; i++)
+	{
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		struct sockaddr_in address;
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = inet_addr("127.0.0.1");
+		bool connected = connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0;
+		close(fd);
+		if (connected)
+		{
+			return true;
+		}
+		this_thread::sleep_for(chrono::milliseconds(50));
+	}
+
+	return false;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned short port = argc > 1 ? atoi(argv[1]) : 8765;
+
+	HttpServer server;
+	server.config.address = "127.0.0.1";
+	server.config.port = port;
+	// Blocked requests must leave threads for /release
+	server.config.thread_pool_size = HTTP_HELPER_WORKERS + 4;
+
+	server.resource["^/echo$"]["POST"] = [](shared_ptr<HttpServer::Response> response,
+						shared_ptr<HttpServer::Request> request)
+	{
+		reply(response, request->content.string());
+	};
+	server.resource["^/block$"]["POST"] = [](shared_ptr<HttpServer::Response> response,
+						 shared_ptr<HttpServer::Request> request)
+	{
+		{
+			unique_lock<mutex> guard(blockMutex);
+			blockCond.wait(guard, [] { return released; });
+		}
+		reply(response, request->content.string());
+	};
+	server.resource["^/release$"]["POST"] = [](shared_ptr<HttpServer::Response> response,
+						   shared_ptr<HttpServer::Request> request)
+	{
+		{
+			lock_guard<mutex> guard(blockMutex);
+			released = true;
+		}
+		blockCond.notify_all();
+		reply(response, "");
+	};
+
+	thread serverThread([&server] { server.start(); });
+	if (!waitListening(port))
+	{
+		fprintf(stderr, "Unable to start the HTTP server on port %u\n", port);
+		server.stop();
+		serverThread.join();
+		return 1;
+	}
+
+	Py_Initialize();
+
+	long failures = -1;
+	PyObject* globals = PyDict_New();
+	PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+	PyObject* value;
+	PyDict_SetItemString(globals, "port", value = PyLong_FromLong(port));
+	Py_DECREF(value);
+	PyDict_SetItemString(globals, "workers", value = PyLong_FromLong(HTTP_HELPER_WORKERS));
+	Py_DECREF(value);
+	PyDict_SetItemString(globals, "queueSize", value = PyLong_FromLong(HTTP_HELPER_QUEUE_SIZE));
+	Py_DECREF(value);
+
+	if (!HttpHelper::registerModule())
+	{
+		fprintf(stderr, "Unable to add the %s module\n", HTTP_HELPER_MODULE);
+	}
+	else
+	{
+		PyObject* pReturn = PyRun_String(checks, Py_file_input, globals, globals);
+		if (pReturn)
+		{
+			failures = PyList_Size(PyDict_GetItemString(globals, "failures"));
+		}
+		else
+		{
+			PyErr_Print();
+		}
+		Py_XDECREF(pReturn);
+	}
+	Py_DECREF(globals);
+
+	// The helper workers live as long as the process, the
+	// interpreter is not finalised
+	PyEval_SaveThread();
+
+	{
+		lock_guard<mutex> guard(blockMutex);
+		released = true;
+	}
+	blockCond.notify_all();
+	server.stop();
+	serverThread.join();
+
+	if (failures != 0)
+	{
+		printf("FAILED\n");
+		return 1;
+	}
+	printf("PASSED\n");
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Fledge "Python 3.5" notification plugin delivery replay.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "delivery_trace.h"
+#include "tool_utils.h"
+
+/**
+ * Replay a delivery trace captured by the plugin "traceFile" option
+ * through the plugin and report delivery latency and throughput.
+ *
+ * Usage: notify_replay <category JSON file> <trace file> [speed]
+ *
+ * The category JSON file is the delivery configuration category,
+ * as returned by the Fledge configuration API, its "traceFile" is
+ * ignored.
+ * The speed is 1 for original timing, greater than 1 to accelerate
+ * and 0 to replay as fast as possible, the default.
+ * Scripts are loaded from the scripts directory under FLEDGE_DATA.
+ */
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "Usage: %s <category JSON file> <trace file> [speed]\n", argv[0]);
+		return 1;
+	}
+
+	double speed = argc > 3 ? atof(argv[3]) : 0.0;
+
+	string config;
+	if (!readFile(argv[1], config))
+	{
+		fprintf(stderr, "Unable to read configuration '%s'\n", argv[1]);
+		return 1;
+	}
+	// Never capture the deliveries being replayed
+	config = setItemAttribute(config, "traceFile", "value", "");
+
+	DeliveryTraceReader reader(argv[2]);
+	if (!reader.isOpen())
+	{
+		fprintf(stderr, "Unable to read delivery trace '%s'\n", argv[2]);
+		return 1;
+	}
+
+	ConfigCategory category("replay", config);
+	PLUGIN_HANDLE handle = plugin_init(&category);
+	if (!handle)
+	{
+		fprintf(stderr, "Plugin initialisation has failed\n");
+		return 1;
+	}
+
+	DeliveryTraceRecord record;
+	vector<double> latencies;
+	long failures = 0;
+	uint64_t firstTimestamp = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	while (reader.next(record))
+	{
+		if (latencies.empty() && failures == 0)
+		{
+			firstTimestamp = record.m_timestamp;
+		}
+
+		// Keep original spacing between deliveries, scaled by speed
+		if (speed > 0 && record.m_timestamp > firstTimestamp)
+		{
+			chrono::microseconds offset((uint64_t)((record.m_timestamp - firstTimestamp) / speed));
+			this_thread::sleep_until(start + offset);
+		}
+
+		chrono::steady_clock::time_point sent = chrono::steady_clock::now();
+		bool ret = plugin_deliver(handle,
+					  record.m_deliveryName,
+					  record.m_notificationName,
+					  record.m_triggerReason,
+					  record.m_message);
+		latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - sent).count());
+		if (!ret)
+		{
+			failures++;
+		}
+	}
+
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	plugin_shutdown((PLUGIN_HANDLE *)handle);
+
+	if (latencies.empty())
+	{
+		printf("No deliveries in trace '%s'\n", argv[2]);
+		return 0;
+	}
+
+	size_t count = latencies.size();
+	printf("Deliveries:   %zu (%ld failed)\n", count, failures);
+	printf("Elapsed:      %.3f s\n", elapsed);
+	printf("Throughput:   %.1f deliveries/s\n", elapsed > 0 ? count / elapsed : 0.0);
+	printLatencies("Latency", latencies);
+
+	return failures ? 2 : 0;
+}
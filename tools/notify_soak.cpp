@@ -0,0 +1,300 @@
+/*
+ * Fledge "Python 3.5" notification plugin memory soak test.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <Python.h>
+#include "tool_utils.h"
+
+/**
+ * Run many deliveries, script reloads and failing script calls,
+ * sampling RSS, Python object counts and tracemalloc traced memory,
+ * and fail if they grow beyond a threshold.
+ *
+ * Usage: notify_soak <category JSON file> [options]
+ *
+ *	-n <deliveries>		Deliveries, default 1000000
+ *	-r <reloads>		Reloads of the script, default 1000
+ *	-f <script file>	Script whose method raises, for failing calls
+ *	-e <failures>		Failing calls, default 1000, needs -f
+ *	-s <samples>		Samples taken over the run, default 20
+ *	-g			Set idle garbage collection, freezing on each reload
+ *	-c			Compile the script, loading the extension on each reload
+ *	-m <kB>			Maximum RSS growth, default 10240
+ *	-o <objects>		Maximum Python object count growth, default 10000
+ *
+ * Each failing call reconfigures to the failing script, delivers once
+ * and reconfigures back, as a failed script is only called once.
+ * The exit status is 0 if growth is within the thresholds, 2 if not.
+ */
+
+using namespace std;
+
+// Python helpers sampling the interpreter
+static const char *soakHelpers =
+	"import gc, sys, tracemalloc\n"
+	"def objects():\n"
+	"    gc.collect()\n"
+	"    if hasattr(sys, 'getobjects'):\n"
+	"        return len(sys.getobjects(0))\n"
+	"    frozen = gc.get_freeze_count() if hasattr(gc, 'get_freeze_count') else 0\n"
+	"    return len(gc.get_objects()) + frozen\n"
+	"def traced():\n"
+	"    return tracemalloc.get_traced_memory()[0]\n"
+	"def snapshot():\n"
+	"    return tracemalloc.take_snapshot()\n"
+	"def growth(first, last):\n"
+	"    return [str(s) for s in last.compare_to(first, 'lineno')[:10]]\n";
+
+/**
+ * A sample of the process memory
+ */
+class Sample
+{
+	public:
+		long	m_rss;
+		long	m_objects;
+		long	m_traced;
+};
+
+/**
+ * Call a helper and return its result as a long
+ */
+static long callHelper(PyObject* helpers, const char *name)
+{
+	long value = -1;
+	PyObject* func = PyDict_GetItemString(helpers, name);
+	PyObject* pReturn = func ? PyObject_CallFunction(func, NULL) : NULL;
+	if (pReturn)
+	{
+		value = PyLong_AsLong(pReturn);
+	}
+	else
+	{
+		PyErr_Print();
+	}
+	Py_XDECREF(pReturn);
+
+	return value;
+}
+
+/**
+ * Take a sample, the GIL must be held
+ */
+static Sample takeSample(PyObject* helpers)
+{
+	Sample sample;
+	sample.m_objects = callHelper(helpers, "objects");
+	sample.m_traced = callHelper(helpers, "traced");
+	sample.m_rss = residentSetSize();
+
+	return sample;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <category JSON file> [-n deliveries] [-r reloads] "
+				"[-f failing script file] [-e failures] [-s samples] [-g] [-c] "
+				"[-m max RSS growth kB] [-o max object growth]\n", argv[0]);
+		return 1;
+	}
+
+	long deliveries = 1000000, reloads = 1000, failures = 1000;
+	long samples = 20, maxRSSGrowth = 10240, maxObjectGrowth = 10000;
+	bool idleGC = false, compile = false;
+	string failingScript;
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-g") == 0)
+		{
+			idleGC = true;
+		}
+		else if (strcmp(argv[i], "-c") == 0)
+		{
+			compile = true;
+		}
+		else if (i + 1 >= argc)
+		{
+			break;
+		}
+		else if (strcmp(argv[i], "-n") == 0)
+		{
+			deliveries = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-r") == 0)
+		{
+			reloads = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-f") == 0)
+		{
+			failingScript = argv[++i];
+		}
+		else if (strcmp(argv[i], "-e") == 0)
+		{
+			failures = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-s") == 0)
+		{
+			samples = max(1L, atol(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-m") == 0)
+		{
+			maxRSSGrowth = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-o") == 0)
+		{
+			maxObjectGrowth = atol(argv[++i]);
+		}
+	}
+	if (failingScript.empty())
+	{
+		failures = 0;
+	}
+
+	string config;
+	if (!readFile(argv[1], config))
+	{
+		fprintf(stderr, "Unable to read configuration '%s'\n", argv[1]);
+		return 1;
+	}
+	config = setItemAttribute(config, "traceFile", "value", "");
+	config = setItemAttribute(config, "enable", "value", "true");
+	if (idleGC)
+	{
+		config = setItemAttribute(config, "gcMode", "value", "idle");
+	}
+	if (compile)
+	{
+		config = setItemAttribute(config, "compileScript", "value", "true");
+	}
+	string failingConfig = setItemAttribute(config, "script", "file", failingScript);
+
+	ConfigCategory category("soak", config);
+	PLUGIN_HANDLE handle = plugin_init(&category);
+	if (!handle)
+	{
+		fprintf(stderr, "Plugin initialisation has failed\n");
+		return 1;
+	}
+
+	PyGILState_STATE state = PyGILState_Ensure();
+	PyObject* helpers = PyDict_New();
+	PyDict_SetItemString(helpers, "__builtins__", PyEval_GetBuiltins());
+	PyObject* pReturn = PyRun_String(soakHelpers, Py_file_input, helpers, helpers);
+	if (!pReturn)
+	{
+		PyErr_Print();
+		PyGILState_Release(state);
+		return 1;
+	}
+	Py_DECREF(pReturn);
+	PyRun_SimpleString("import tracemalloc\ntracemalloc.start()\n");
+	PyGILState_Release(state);
+
+	// Warm up so that one off allocations are not counted as growth
+	long delivered = 0, failed = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		plugin_deliver(handle, "soak", "soak", "triggered", "warm up");
+	}
+	string newConfig = config;
+	plugin_reconfigure((PLUGIN_HANDLE *)handle, newConfig);
+
+	state = PyGILState_Ensure();
+	Sample first = takeSample(helpers);
+	PyObject* firstSnapshot = PyObject_CallFunction(PyDict_GetItemString(helpers, "snapshot"), NULL);
+	PyGILState_Release(state);
+
+	printf("%8s %12s %12s %12s %12s\n", "sample", "deliveries", "RSS kB", "objects", "traced B");
+	printf("%8d %12ld %12ld %12ld %12ld\n", 0, 0L, first.m_rss, first.m_objects, first.m_traced);
+
+	Sample last = first;
+	for (long s = 1; s <= samples; s++)
+	{
+		for (long i = 0; i < deliveries / samples; i++)
+		{
+			char message[64];
+			snprintf(message, sizeof(message), "soak %ld", delivered);
+			if (!plugin_deliver(handle, "soak", "soak", "triggered", message))
+			{
+				failed++;
+			}
+			delivered++;
+		}
+		for (long i = 0; i < reloads / samples; i++)
+		{
+			newConfig = config;
+			plugin_reconfigure((PLUGIN_HANDLE *)handle, newConfig);
+		}
+		for (long i = 0; i < failures / samples; i++)
+		{
+			newConfig = failingConfig;
+			plugin_reconfigure((PLUGIN_HANDLE *)handle, newConfig);
+			plugin_deliver(handle, "soak", "soak", "triggered", "fail");
+			newConfig = config;
+			plugin_reconfigure((PLUGIN_HANDLE *)handle, newConfig);
+		}
+
+		state = PyGILState_Ensure();
+		last = takeSample(helpers);
+		PyGILState_Release(state);
+		printf("%8ld %12ld %12ld %12ld %12ld\n",
+		       s, delivered, last.m_rss, last.m_objects, last.m_traced);
+		fflush(stdout);
+	}
+
+	// Where traced memory has grown
+	state = PyGILState_Ensure();
+	PyObject* lastSnapshot = PyObject_CallFunction(PyDict_GetItemString(helpers, "snapshot"), NULL);
+	PyObject* growth = (firstSnapshot && lastSnapshot) ?
+			   PyObject_CallFunction(PyDict_GetItemString(helpers, "growth"),
+						 "OO", firstSnapshot, lastSnapshot) : NULL;
+	if (growth)
+	{
+		printf("Largest tracemalloc growth:\n");
+		for (Py_ssize_t i = 0; i < PyList_Size(growth); i++)
+		{
+			printf("  %s\n", PyUnicode_AsUTF8(PyList_GetItem(growth, i)));
+		}
+	}
+	else
+	{
+		PyErr_Print();
+	}
+	Py_XDECREF(growth);
+	Py_XDECREF(lastSnapshot);
+	Py_XDECREF(firstSnapshot);
+	PyRun_SimpleString("import tracemalloc\ntracemalloc.stop()\n");
+	Py_DECREF(helpers);
+	PyGILState_Release(state);
+
+	plugin_shutdown((PLUGIN_HANDLE *)handle);
+
+	long rssGrowth = last.m_rss - first.m_rss;
+	long objectGrowth = last.m_objects - first.m_objects;
+	printf("Deliveries %ld (%ld not delivered), reloads %ld, failing calls %ld\n",
+	       delivered, failed, reloads, failures);
+	printf("RSS growth %ld kB (maximum %ld), object growth %ld (maximum %ld), "
+	       "traced memory growth %ld bytes\n",
+	       rssGrowth, maxRSSGrowth,
+	       objectGrowth, maxObjectGrowth,
+	       last.m_traced - first.m_traced);
+
+	if (rssGrowth > maxRSSGrowth || objectGrowth > maxObjectGrowth)
+	{
+		printf("FAILED: memory growth is above the threshold\n");
+		return 2;
+	}
+	printf("PASSED\n");
+
+	return 0;
+}
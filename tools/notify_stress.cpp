@@ -0,0 +1,219 @@
+/*
+ * Fledge "Python 3.5" notification plugin deliver and reconfigure stress.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "tool_utils.h"
+
+/**
+ * Deliver notifications from many threads while the plugin is
+ * reconfigured at a fixed rate, and report delivery latency outside
+ * and during reconfigurations, throughput per second and RSS growth.
+ *
+ * Usage: notify_stress <category JSON file> [options]
+ *
+ *	-t <threads>		Delivery threads, default 4
+ *	-d <seconds>		Duration, default 10
+ *	-r <per second>		Reconfigurations per second, default 2, 0 for none
+ *	-s <script file>	Script to switch to, optional
+ *	-b <script file>	Broken script to switch to, optional
+ *
+ * Reconfigurations cycle through reloading the same script, switching
+ * script, loading the broken script and disabling then enabling the
+ * delivery. Build with -DSANITIZE=thread or -DSANITIZE=address to
+ * check the plugin locking and memory handling.
+ */
+
+using namespace std;
+using namespace std::chrono;
+
+// Per second throughput is recorded for up to this many seconds
+#define MAX_SECONDS 3600
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <category JSON file> [-t threads] [-d seconds] "
+				"[-r reconfigurations per second] [-s script file] "
+				"[-b broken script file]\n", argv[0]);
+		return 1;
+	}
+
+	int nThreads = 4;
+	long runTime = 10;
+	double rate = 2;
+	string altScript, brokenScript;
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "-t") == 0)
+		{
+			nThreads = max(1, atoi(argv[i + 1]));
+		}
+		else if (strcmp(argv[i], "-d") == 0)
+		{
+			runTime = min((long)MAX_SECONDS, max(1L, atol(argv[i + 1])));
+		}
+		else if (strcmp(argv[i], "-r") == 0)
+		{
+			rate = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-s") == 0)
+		{
+			altScript = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-b") == 0)
+		{
+			brokenScript = argv[i + 1];
+		}
+	}
+
+	string config;
+	if (!readFile(argv[1], config))
+	{
+		fprintf(stderr, "Unable to read configuration '%s'\n", argv[1]);
+		return 1;
+	}
+	config = setItemAttribute(config, "traceFile", "value", "");
+	config = setItemAttribute(config, "enable", "value", "true");
+
+	// The configurations the reconfiguration thread cycles through
+	vector<string> configs;
+	configs.push_back(config);
+	if (!altScript.empty())
+	{
+		configs.push_back(setItemAttribute(config, "script", "file", altScript));
+		configs.push_back(config);
+	}
+	if (!brokenScript.empty())
+	{
+		configs.push_back(setItemAttribute(config, "script", "file", brokenScript));
+		configs.push_back(config);
+	}
+	configs.push_back(setItemAttribute(config, "enable", "value", "false"));
+	configs.push_back(config);
+
+	ConfigCategory category("stress", config);
+	PLUGIN_HANDLE handle = plugin_init(&category);
+	if (!handle)
+	{
+		fprintf(stderr, "Plugin initialisation has failed\n");
+		return 1;
+	}
+
+	long startRSS = residentSetSize();
+	atomic<bool> stop(false);
+	atomic<int> reconfiguring(0);
+	atomic<long> perSecond[MAX_SECONDS];
+	for (int i = 0; i < MAX_SECONDS; i++)
+	{
+		perSecond[i] = 0;
+	}
+	// Fixed size, so that RSS growth is the plugin's, not the tool's
+	vector<LatencyHistogram> steady(nThreads), duringReload(nThreads);
+	vector<long> failures(nThreads, 0);
+	steady_clock::time_point start = steady_clock::now();
+
+	vector<thread> threads;
+	for (int t = 0; t < nThreads; t++)
+	{
+		threads.push_back(thread([&, t]()
+		{
+			char message[64];
+			for (long n = 0; !stop; n++)
+			{
+				snprintf(message, sizeof(message), "stress %d %ld", t, n);
+				bool reloading = reconfiguring > 0;
+				steady_clock::time_point sent = steady_clock::now();
+				bool ret = plugin_deliver(handle, "stress", "stress", "triggered", message);
+				steady_clock::time_point done = steady_clock::now();
+
+				double latency = duration_cast<duration<double, micro> >(done - sent).count();
+				(reloading || reconfiguring > 0 ? duringReload[t] : steady[t]).record(latency);
+				if (!ret)
+				{
+					failures[t]++;
+				}
+				long second = duration_cast<seconds>(done - start).count();
+				if (second < MAX_SECONDS)
+				{
+					perSecond[second]++;
+				}
+			}
+		}));
+	}
+
+	// Reconfigure at the requested rate until the end of the run
+	long reconfigurations = 0;
+	long maxRSS = startRSS;
+	steady_clock::time_point end = start + seconds(runTime);
+	while (steady_clock::now() < end)
+	{
+		if (rate > 0)
+		{
+			this_thread::sleep_for(duration<double>(1.0 / rate));
+			reconfiguring++;
+			string newConfig = configs[reconfigurations % configs.size()];
+			plugin_reconfigure((PLUGIN_HANDLE *)handle, newConfig);
+			reconfiguring--;
+			reconfigurations++;
+		}
+		else
+		{
+			this_thread::sleep_for(milliseconds(100));
+		}
+		maxRSS = max(maxRSS, residentSetSize());
+	}
+
+	stop = true;
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+	double elapsed = duration_cast<duration<double> >(steady_clock::now() - start).count();
+	long endRSS = residentSetSize();
+
+	plugin_shutdown((PLUGIN_HANDLE *)handle);
+
+	LatencyHistogram steadyAll, reloadAll;
+	long failed = 0;
+	for (int t = 0; t < nThreads; t++)
+	{
+		steadyAll.merge(steady[t]);
+		reloadAll.merge(duringReload[t]);
+		failed += failures[t];
+	}
+	long total = steadyAll.getCount() + reloadAll.getCount();
+
+	long minPerSecond = -1, maxPerSecond = 0;
+	for (long i = 0; i < (long)elapsed && i < MAX_SECONDS; i++)
+	{
+		long count = perSecond[i];
+		minPerSecond = minPerSecond < 0 ? count : min(minPerSecond, count);
+		maxPerSecond = max(maxPerSecond, count);
+	}
+
+	printf("Threads:          %d\n", nThreads);
+	printf("Reconfigurations: %ld\n", reconfigurations);
+	printf("Deliveries:       %ld (%ld not delivered)\n", total, failed);
+	printf("Throughput:       %.1f deliveries/s, per second min %ld max %ld\n",
+	       elapsed > 0 ? total / elapsed : 0.0,
+	       max(minPerSecond, 0L),
+	       maxPerSecond);
+	steadyAll.print("Latency");
+	reloadAll.print("Latency during reconfiguration");
+	printf("RSS (kB):         start %ld  max %ld  end %ld  growth %ld\n",
+	       startRSS, maxRSS, endRSS, endRSS - startRSS);
+
+	return 0;
+}
@@ -0,0 +1,237 @@
+#ifndef _TOOL_UTILS_H
+#define _TOOL_UTILS_H
+/*
+ * Fledge "Python 3.5" notification plugin tools helpers.
+ *
+ * Copyright (c) 2026 Dianomic Systems
+ *
+ * Released under the Apache 2.0 Licence
+ */
+
+#include <plugin_api.h>
+#include <config_category.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+/**
+ * The delivery plugin entry points, the tools link the plugin library
+ */
+extern "C" {
+PLUGIN_HANDLE plugin_init(ConfigCategory* config);
+bool plugin_deliver(PLUGIN_HANDLE handle,
+		    const std::string& deliveryName,
+		    const std::string& notificationName,
+		    const std::string& triggerReason,
+		    const std::string& message);
+void plugin_shutdown(PLUGIN_HANDLE *handle);
+void plugin_reconfigure(PLUGIN_HANDLE *handle,
+			std::string& newConfig);
+};
+
+/**
+ * Read a whole file
+ *
+ * @param fileName	The file to read
+ * @param content	Set to the file content
+ * @return		False if the file can not be read
+ */
+inline bool readFile(const std::string& fileName, std::string& content)
+{
+	std::ifstream file(fileName.c_str());
+	if (!file)
+	{
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	content = buffer.str();
+
+	return true;
+}
+
+/**
+ * Set an attribute of a configuration item in a category JSON document
+ *
+ * @param config	The category JSON document
+ * @param item		The configuration item name
+ * @param attribute	The attribute to set, e.g. "value" or "file"
+ * @param value		The new attribute value
+ * @return		The modified category JSON document
+ */
+inline std::string setItemAttribute(const std::string& config,
+				    const char *item,
+				    const char *attribute,
+				    const std::string& value)
+{
+	rapidjson::Document doc;
+	doc.Parse(config.c_str());
+	if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember(item))
+	{
+		return config;
+	}
+
+	rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+	rapidjson::Value& itemValue = doc[item];
+	if (itemValue.HasMember(attribute))
+	{
+		itemValue[attribute].SetString(value.c_str(), value.length(), allocator);
+	}
+	else
+	{
+		itemValue.AddMember(rapidjson::Value(attribute, allocator).Move(),
+				    rapidjson::Value(value.c_str(), value.length(), allocator).Move(),
+				    allocator);
+	}
+
+	rapidjson::StringBuffer buffer;
+	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+	doc.Accept(writer);
+
+	return buffer.GetString();
+}
+
+/**
+ * Return the resident set size of the process in kilobytes
+ */
+inline long residentSetSize()
+{
+	long pages = 0, resident = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (statm)
+	{
+		if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+		{
+			resident = 0;
+		}
+		fclose(statm);
+	}
+
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Latency histogram buckets, exact below 64 us then 64 per power of two
+#define LATENCY_SUB_BUCKETS 64
+#define LATENCY_BUCKETS (LATENCY_SUB_BUCKETS * 27)
+
+/**
+ * A fixed size histogram of latencies in microseconds
+ *
+ * Recording does not allocate, so that long runs do not grow the
+ * RSS of the tool. Percentiles are accurate to within 1/64 of the
+ * value, latencies above 2^32 us are counted in the last bucket.
+ */
+class LatencyHistogram
+{
+	public:
+		LatencyHistogram() : m_buckets(LATENCY_BUCKETS, 0), m_count(0), m_max(0) {};
+
+		void	record(double latency)
+		{
+			m_buckets[bucket(latency > 0 ? (unsigned long)latency : 0)]++;
+			m_count++;
+			m_max = std::max(m_max, latency);
+		};
+		void	merge(const LatencyHistogram& other)
+		{
+			for (size_t i = 0; i < m_buckets.size(); i++)
+			{
+				m_buckets[i] += other.m_buckets[i];
+			}
+			m_count += other.m_count;
+			m_max = std::max(m_max, other.m_max);
+		};
+		long	getCount() const { return m_count; };
+		double	percentile(double fraction) const
+		{
+			long rank = (long)(m_count * fraction);
+			long seen = 0;
+			for (size_t i = 0; i < m_buckets.size(); i++)
+			{
+				seen += m_buckets[i];
+				if (seen > rank)
+				{
+					return std::min(lowest(i), m_max);
+				}
+			}
+			return m_max;
+		};
+		void	print(const char *label) const
+		{
+			if (m_count == 0)
+			{
+				printf("%s: no deliveries\n", label);
+				return;
+			}
+			printf("%s (us): count %ld  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+			       label,
+			       m_count,
+			       percentile(0.5),
+			       percentile(0.9),
+			       percentile(0.99),
+			       m_max);
+		};
+
+	private:
+		static size_t
+			bucket(unsigned long value)
+		{
+			if (value < LATENCY_SUB_BUCKETS)
+			{
+				return value;
+			}
+			int shift = 63 - __builtin_clzl(value) - 6;
+			size_t index = LATENCY_SUB_BUCKETS * (shift + 1) +
+					(value >> shift) - LATENCY_SUB_BUCKETS;
+			return std::min(index, (size_t)LATENCY_BUCKETS - 1);
+		};
+		static double
+			lowest(size_t index)
+		{
+			if (index < LATENCY_SUB_BUCKETS)
+			{
+				return index;
+			}
+			int shift = index / LATENCY_SUB_BUCKETS - 1;
+			return (double)((LATENCY_SUB_BUCKETS + index % LATENCY_SUB_BUCKETS) << shift);
+		};
+
+	private:
+		std::vector<long>
+				m_buckets;
+		long		m_count;
+		double		m_max;
+};
+
+/**
+ * Print the percentiles of a set of latencies in microseconds
+ *
+ * @param label		The label of the latencies
+ * @param latencies	The latencies, sorted by this function
+ */
+inline void printLatencies(const char *label, std::vector<double>& latencies)
+{
+	if (latencies.empty())
+	{
+		printf("%s: no deliveries\n", label);
+		return;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	size_t count = latencies.size();
+	printf("%s (us): count %zu  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+	       label,
+	       count,
+	       latencies[count / 2],
+	       latencies[(count * 9) / 10],
+	       latencies[(count * 99) / 100],
+	       latencies[count - 1]);
+}
+#endif